@@ -68,6 +68,11 @@ namespace pimoroni {
     write(pointToAddress(p), l, colour);
   }
 
+  void PSRamDisplay::write_pixels(const Point &p, uint l, const uint8_t *data)
+  {
+    write(pointToAddress(p), l, data);
+  }
+
   void PSRamDisplay::read_pixel_span(const Point &p, uint l, uint8_t *data)
   {
     read(pointToAddress(p), l, data);
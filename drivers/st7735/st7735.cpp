@@ -123,16 +123,7 @@ namespace pimoroni {
       offset_cols = (ROWS - width) / 2;
       offset_rows = (COLS - height) / 2;
 
-      char buf[4];
-      buf[0] = 0; 
-      buf[1] = offset_cols;
-      buf[2] = 0;
-      buf[3] = width + offset_cols - 1;
-      command(reg::CASET, 4, buf);
-
-      buf[1] = offset_rows;
-      buf[3] = height + offset_rows - 1;
-      command(reg::RASET, 4, buf);
+      set_window(Rect(0, 0, width, height));
 
       command(reg::GMCTRP1, 16, "\x02\x1c\x07\x12\x37\x32\x29\x2d\x29\x25\x2b\x39\x00\x01\x03\x10");
       command(reg::GMCTRN1, 16, "\x03\x1d\x07\x06\x2e\x2c\x29\x2d\x2e\x2e\x37\x3f\x00\x00\x02\x10");
@@ -163,6 +154,24 @@ namespace pimoroni {
     gpio_put(cs, 1);
   }
 
+  void ST7735::set_window(const Rect &r) {
+    uint16_t x1 = r.x + offset_cols, x2 = r.x + r.w + offset_cols - 1;
+    uint16_t y1 = r.y + offset_rows, y2 = r.y + r.h + offset_rows - 1;
+
+    char buf[4];
+    buf[0] = x1 >> 8;
+    buf[1] = x1 & 0xff;
+    buf[2] = x2 >> 8;
+    buf[3] = x2 & 0xff;
+    command(reg::CASET, 4, buf);
+
+    buf[0] = y1 >> 8;
+    buf[1] = y1 & 0xff;
+    buf[2] = y2 >> 8;
+    buf[3] = y2 & 0xff;
+    command(reg::RASET, 4, buf);
+  }
+
   // Native 16-bit framebuffer update
   void ST7735::update(PicoGraphics *graphics) {
     if(graphics->pen_type == PicoGraphics::PEN_RGB565) {
@@ -182,6 +191,69 @@ namespace pimoroni {
     }
   }
 
+  void ST7735::partial_update(PicoGraphics *graphics, Rect region) {
+    region = region.intersection(graphics->bounds);
+    if(region.empty()) return;
+
+    write_window(graphics, region, Point(region.x, region.y));
+  }
+
+  void ST7735::update_strip(PicoGraphics *graphics, int32_t y) {
+    write_window(graphics, graphics->bounds, Point(0, y));
+  }
+
+  // sends `region` of the frame buffer to the display at `dest`
+  void ST7735::write_window(PicoGraphics *graphics, const Rect &region, const Point &dest) {
+    set_window(Rect(dest.x, dest.y, region.w, region.h));
+
+    command(reg::RAMWR);
+    gpio_put(dc, 1); // data mode
+    gpio_put(cs, 0);
+
+    if(graphics->pen_type == PicoGraphics::PEN_RGB565) {
+      const uint16_t *src = (const uint16_t *)graphics->frame_buffer + region.y * graphics->bounds.w + region.x;
+      if(region.w == graphics->bounds.w) {
+        // whole rows are contiguous in the frame buffer
+        spi_write_blocking(spi, (const uint8_t*)src, region.w * region.h * sizeof(uint16_t));
+      } else {
+        for(auto row = 0; row < region.h; row++) {
+          spi_write_blocking(spi, (const uint8_t*)src, region.w * sizeof(uint16_t));
+          src += graphics->bounds.w;
+        }
+      }
+    } else {
+      graphics->frame_convert_rect(PicoGraphics::PEN_RGB565, region, [this](void *data, size_t length) {
+        if (length > 0) {
+          spi_write_blocking(spi, (const uint8_t*)data, length);
+        }
+      });
+    }
+
+    gpio_put(cs, 1);
+
+    // restore the full window for update()
+    set_window(Rect(0, 0, width, height));
+  }
+
+  void ST7735::update_damaged(PicoGraphics *graphics) {
+    // each region costs a few commands to set up, once most of the display
+    // is damaged it's quicker to send all of it
+    int32_t area = 0;
+    for(auto i = 0u; i < graphics->damage_count; i++) {
+      area += graphics->damage[i].w * graphics->damage[i].h;
+    }
+
+    if(area * 4 > graphics->bounds.w * graphics->bounds.h * 3) {
+      update(graphics);
+    } else {
+      for(auto i = 0u; i < graphics->damage_count; i++) {
+        partial_update(graphics, graphics->damage[i]);
+      }
+    }
+
+    graphics->clear_damage();
+  }
+
   void ST7735::set_backlight(uint8_t brightness) {
     // gamma correct the provided 0-255 brightness value onto a
     // 0-65535 range for the pwm counter
@@ -53,11 +53,16 @@ namespace pimoroni {
     //--------------------------------------------------
   public:
     void update(PicoGraphics *graphics) override;
+    void partial_update(PicoGraphics *graphics, Rect region) override;
+    void update_damaged(PicoGraphics *graphics) override;
+    void update_strip(PicoGraphics *graphics, int32_t y) override;
     void set_backlight(uint8_t brightness) override;
 
   private:
     void init(bool auto_init_sequence = true);
     void command(uint8_t command, size_t len = 0, const char *data = NULL);
+    void set_window(const Rect &r);
+    void write_window(PicoGraphics *graphics, const Rect &region, const Point &dest);
   };
 
 }
@@ -250,6 +250,8 @@ namespace pimoroni {
   }
 
   void ST7789::command(uint8_t command, size_t len, const char *data) {
+    wait_idle();
+
     gpio_put(dc, 0); // command mode
 
     gpio_put(cs, 0);
@@ -273,6 +275,8 @@ namespace pimoroni {
   }
   
   void ST7789::update(PicoGraphics *graphics) {
+    wait_idle();
+
     uint8_t cmd = reg::RAMWR;
 
     if(graphics->pen_type == PicoGraphics::PEN_RGB565) { // Display buffer is screen native
@@ -301,6 +305,144 @@ namespace pimoroni {
     }
   }
 
+  void ST7789::present_async(PicoGraphics *graphics) {
+    // other pens are converted by the cpu as they're sent
+    if(graphics->pen_type != PicoGraphics::PEN_RGB565) {
+      update(graphics);
+      return;
+    }
+
+    wait_idle();
+
+    uint8_t cmd = reg::RAMWR;
+    gpio_put(dc, 0); // command mode
+    gpio_put(cs, 0);
+    if(spi) { // SPI Bus
+      spi_write_blocking(spi, &cmd, 1);
+    } else { // Parallel Bus
+      write_blocking_parallel(&cmd, 1);
+    }
+
+    gpio_put(dc, 1); // data mode
+
+    // leave the whole frame to DMA, chip select stays low until it's done
+    write_blocking_dma((const uint8_t *)graphics->frame_buffer, width * height * sizeof(uint16_t));
+    presenting = true;
+  }
+
+  bool ST7789::is_busy() {
+    if(!presenting) return false;
+
+    if(dma_channel_is_busy(st_dma)) return true;
+
+    // the last few bytes may still be in the SPI or PIO fifo
+    if(spi) {
+      if(spi_is_busy(spi)) return true;
+    } else {
+      if(!pio_sm_is_tx_fifo_empty(parallel_pio, parallel_sm)) return true;
+    }
+
+    gpio_put(cs, 1);
+    presenting = false;
+    return false;
+  }
+
+  void ST7789::wait_idle() {
+    while(is_busy())
+      ;
+  }
+
+  void ST7789::partial_update(PicoGraphics *graphics, Rect region) {
+    region = region.intersection(graphics->bounds);
+    if(region.empty()) return;
+
+    write_window(graphics, region, Point(region.x, region.y));
+  }
+
+  void ST7789::update_strip(PicoGraphics *graphics, int32_t y) {
+    write_window(graphics, graphics->bounds, Point(0, y));
+  }
+
+  // sends `region` of the frame buffer to the display at `dest`
+  void ST7789::write_window(PicoGraphics *graphics, const Rect &region, const Point &dest) {
+    // narrow the address window to the region, caset and raset hold the full
+    // window byte swapped ready to send
+    uint16_t x = __builtin_bswap16(caset[0]) + dest.x;
+    uint16_t y = __builtin_bswap16(raset[0]) + dest.y;
+    uint16_t window_caset[2] = {__builtin_bswap16(x), __builtin_bswap16(x + region.w - 1)};
+    uint16_t window_raset[2] = {__builtin_bswap16(y), __builtin_bswap16(y + region.h - 1)};
+    command(reg::CASET, 4, (char *)window_caset);
+    command(reg::RASET, 4, (char *)window_raset);
+
+    uint8_t cmd = reg::RAMWR;
+    gpio_put(dc, 0); // command mode
+    gpio_put(cs, 0);
+    if(spi) { // SPI Bus
+      spi_write_blocking(spi, &cmd, 1);
+    } else { // Parallel Bus
+      write_blocking_parallel(&cmd, 1);
+    }
+
+    gpio_put(dc, 1); // data mode
+
+    if(graphics->pen_type == PicoGraphics::PEN_RGB565) { // Display buffer is screen native
+      const uint16_t *src = (const uint16_t *)graphics->frame_buffer + region.y * graphics->bounds.w + region.x;
+      if(region.w == graphics->bounds.w) {
+        // whole rows are contiguous in the frame buffer
+        write_blocking_dma((const uint8_t *)src, region.w * region.h * sizeof(uint16_t));
+      } else {
+        for(auto row = 0; row < region.h; row++) {
+          write_blocking_dma((const uint8_t *)src, region.w * sizeof(uint16_t));
+          src += graphics->bounds.w;
+        }
+      }
+      dma_channel_wait_for_finish_blocking(st_dma);
+    } else {
+      graphics->frame_convert_rect(PicoGraphics::PEN_RGB565, region, [this](void *data, size_t length) {
+        if (length > 0) {
+          write_blocking_dma((const uint8_t*)data, length);
+        }
+        else {
+          dma_channel_wait_for_finish_blocking(st_dma);
+        }
+      });
+    }
+
+    // the last few bytes may still be in the SPI or PIO fifo
+    if(spi) {
+      while(spi_is_busy(spi))
+        ;
+    } else {
+      while(!pio_sm_is_tx_fifo_empty(parallel_pio, parallel_sm))
+        ;
+    }
+
+    gpio_put(cs, 1);
+
+    // restore the full window for update()
+    command(reg::CASET, 4, (char *)caset);
+    command(reg::RASET, 4, (char *)raset);
+  }
+
+  void ST7789::update_damaged(PicoGraphics *graphics) {
+    // each region costs a few commands to set up, once most of the display
+    // is damaged it's quicker to send all of it
+    int32_t area = 0;
+    for(auto i = 0u; i < graphics->damage_count; i++) {
+      area += graphics->damage[i].w * graphics->damage[i].h;
+    }
+
+    if(area * 4 > graphics->bounds.w * graphics->bounds.h * 3) {
+      update(graphics);
+    } else {
+      for(auto i = 0u; i < graphics->damage_count; i++) {
+        partial_update(graphics, graphics->damage[i]);
+      }
+    }
+
+    graphics->clear_damage();
+  }
+
   void ST7789::set_backlight(uint8_t brightness) {
     // gamma correct the provided 0-255 brightness value onto a
     // 0-65535 range for the pwm counter
@@ -43,6 +43,7 @@ namespace pimoroni {
     PIO parallel_pio;
     uint parallel_offset;
     uint st_dma;
+    bool presenting = false; // a present_async() transfer holds the bus
 
 
     // The ST7789 requires 16 ns between SPI rising edges.
@@ -132,6 +133,12 @@ namespace pimoroni {
 
     void cleanup() override;
     void update(PicoGraphics *graphics) override;
+    void partial_update(PicoGraphics *graphics, Rect region) override;
+    void update_damaged(PicoGraphics *graphics) override;
+    void update_strip(PicoGraphics *graphics, int32_t y) override;
+    void present_async(PicoGraphics *graphics) override;
+    void wait_idle() override;
+    bool is_busy() override;
     void set_backlight(uint8_t brightness) override;
 
   private:
@@ -139,6 +146,7 @@ namespace pimoroni {
     void configure_display(Rotation rotate);
     void write_blocking_dma(const uint8_t *src, size_t len);
     void write_blocking_parallel(const uint8_t *src, size_t len);
+    void write_window(PicoGraphics *graphics, const Rect &region, const Point &dest);
     void command(uint8_t command, size_t len = 0, const char *data = NULL);
   };
 
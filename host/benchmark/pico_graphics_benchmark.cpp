@@ -0,0 +1,438 @@
+// PicoGraphics primitive benchmarks.
+//
+// Times each drawing primitive for every PicoGraphics_Pen* class at a set of
+// realistic display sizes and prints one result per line, either as CSV
+// (default) or JSON lines.
+//
+// `pixels` is the number of distinct pixels a single call covers, measured
+// once per case with a counting surface, so pixels/sec is comparable across
+// pen types and across implementations that produce the same output.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+using namespace pimoroni;
+
+namespace {
+
+  struct Options {
+    bool json = false;
+    double min_ms = 50.0;
+    std::string pen_filter;
+    std::string case_filter;
+    std::string size_filter;
+  };
+
+  struct Size {
+    int32_t w, h;
+  };
+
+  const Size sizes[] = {
+    {240, 240},
+    {320, 240},
+    {800, 480}
+  };
+
+  // deterministic pseudo-random numbers so every run draws the same shapes
+  struct Random {
+    uint32_t state = 0x1234567;
+    uint32_t next() {
+      state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+      return state;
+    }
+    int32_t range(int32_t lo, int32_t hi) {
+      return lo + int32_t(next() % uint32_t(hi - lo));
+    }
+  };
+
+  // A PicoGraphics surface that records which pixels were written so that the
+  // coverage of a primitive can be measured independently of pen type.
+  class CoverageCounter : public PicoGraphics {
+    public:
+      std::vector<uint8_t> touched;
+
+      CoverageCounter(uint16_t width, uint16_t height)
+      : PicoGraphics(width, height, nullptr), touched(width * height, 0) {
+        this->pen_type = PEN_RGB888;
+      }
+      void set_pen(uint c) override {}
+      void set_pen(uint8_t r, uint8_t g, uint8_t b) override {}
+      void set_pixel(const Point &p) override {
+        if(bounds.contains(p)) touched[p.y * bounds.w + p.x] = 1;
+      }
+      void set_pixel_span(const Point &p, uint l) override {
+        for(auto x = 0u; x < l; x++) set_pixel(Point(p.x + x, p.y));
+      }
+      void reset() {
+        std::fill(touched.begin(), touched.end(), 0);
+      }
+      uint64_t count() const {
+        uint64_t c = 0;
+        for(auto t : touched) c += t;
+        return c;
+      }
+  };
+
+  // Memory-backed stand-in for the Inky 7.3" display so PenInky7 can be timed
+  class MemoryDirectDriver : public IDirectDisplayDriver<uint8_t> {
+    public:
+      uint16_t width, height;
+      std::vector<uint8_t> pixels;
+
+      MemoryDirectDriver(uint16_t width, uint16_t height)
+      : width(width), height(height), pixels(width * height, 0) {}
+
+      void write_pixel(const Point &p, uint8_t colour) override {
+        pixels[p.y * width + p.x] = colour;
+      }
+      void write_pixel_span(const Point &p, uint l, uint8_t colour) override {
+        memset(&pixels[p.y * width + p.x], colour, l);
+      }
+      void write_pixels(const Point &p, uint l, const uint8_t *data) override {
+        memcpy(&pixels[p.y * width + p.x], data, l);
+      }
+      void read_pixel_span(const Point &p, uint l, uint8_t *data) override {
+        memcpy(data, &pixels[p.y * width + p.x], l);
+      }
+  };
+
+  // A single benchmark case. `setup` runs once before timing, `run` is called
+  // with an increasing iteration counter so cases can cycle through inputs.
+  struct Case {
+    std::string name;
+    std::function<void(PicoGraphics &g)> setup;
+    std::function<void(PicoGraphics &g, uint32_t i)> run;
+    // optional fixed per-call pixel count, otherwise coverage is measured
+    int64_t pixels = -1;
+    // optional predicate to skip pen types the primitive isn't implemented for
+    std::function<bool(const PicoGraphics &g)> supported = nullptr;
+  };
+
+  const int INPUT_COUNT = 64;
+
+  const std::string_view sample_text = "The quick brown fox jumps over the lazy dog 0123456789";
+
+  std::vector<Case> build_cases(Size size) {
+    std::vector<Case> cases;
+    const int32_t w = size.w, h = size.h;
+    Random rnd;
+
+    // pre-generate inputs so the generator isn't part of the timing
+    std::vector<Point> line_a(INPUT_COUNT), line_b(INPUT_COUNT);
+    for(auto i = 0; i < INPUT_COUNT; i++) {
+      line_a[i] = Point(rnd.range(0, w), rnd.range(0, h));
+      line_b[i] = Point(rnd.range(0, w), rnd.range(0, h));
+    }
+
+    std::vector<Point> tri_a(INPUT_COUNT), tri_b(INPUT_COUNT), tri_c(INPUT_COUNT);
+    for(auto i = 0; i < INPUT_COUNT; i++) {
+      Point c(rnd.range(w / 4, w * 3 / 4), rnd.range(h / 4, h * 3 / 4));
+      int32_t r = h / 4;
+      tri_a[i] = c + Point(rnd.range(-r, r), rnd.range(-r, r));
+      tri_b[i] = c + Point(rnd.range(-r, r), rnd.range(-r, r));
+      tri_c[i] = c + Point(rnd.range(-r, r), rnd.range(-r, r));
+    }
+
+    // a twelve pointed star, centred and sized relative to the display
+    std::vector<Point> star;
+    for(auto i = 0; i < 24; i++) {
+      float a = float(i) * float(M_PI) / 12.0f;
+      float r = (i & 1) ? h * 0.2f : h * 0.45f;
+      star.push_back(Point(w / 2 + int32_t(cosf(a) * r), h / 2 + int32_t(sinf(a) * r)));
+    }
+
+    // RGB332 sprite sheet, 128 pixels wide with 8x8 cells
+    static std::vector<uint8_t> sheet;
+    if(sheet.empty()) {
+      sheet.resize(128 * 128);
+      for(auto y = 0; y < 128; y++) {
+        for(auto x = 0; x < 128; x++) {
+          // a diamond in each cell, everything else transparent (0)
+          int32_t dx = std::abs((x & 7) * 2 - 7), dy = std::abs((y & 7) * 2 - 7);
+          sheet[y * 128 + x] = (dx + dy) <= 8 ? uint8_t(0x20 + ((x ^ y) & 0xdf)) : 0;
+        }
+      }
+    }
+    const int sprite_scale = 2;
+    int64_t sprite_pixels = 0;
+    for(auto y = 0; y < 8; y++) {
+      for(auto x = 0; x < 8; x++) {
+        if(sheet[y * 128 + x]) sprite_pixels += sprite_scale * sprite_scale;
+      }
+    }
+
+    auto solid = [](PicoGraphics &g) {
+      // pen 1 is a valid, non-dithered entry for every pen type
+      g.set_pen(1);
+    };
+
+    cases.push_back({"clear", solid, [](PicoGraphics &g, uint32_t i) {
+      g.clear();
+    }});
+
+    cases.push_back({"rectangle", solid, [w, h](PicoGraphics &g, uint32_t i) {
+      g.rectangle(Rect((i * 7) % (w / 2), (i * 5) % (h / 2), w / 2, h / 2));
+    }});
+
+    cases.push_back({"rectangle_rgb", [](PicoGraphics &g) {
+      // an RGB pen, which palette types dither or approximate
+      g.set_pen(200, 120, 40);
+    }, [w, h](PicoGraphics &g, uint32_t i) {
+      g.rectangle(Rect((i * 7) % (w / 2), (i * 5) % (h / 2), w / 2, h / 2));
+    }});
+
+    cases.push_back({"circle", solid, [w, h](PicoGraphics &g, uint32_t i) {
+      g.circle(Point(w / 2 + int32_t(i % 16) - 8, h / 2), h / 4);
+    }});
+
+    cases.push_back({"line", solid, [line_a, line_b](PicoGraphics &g, uint32_t i) {
+      g.line(line_a[i % INPUT_COUNT], line_b[i % INPUT_COUNT]);
+    }});
+
+    cases.push_back({"thick_line", solid, [line_a, line_b](PicoGraphics &g, uint32_t i) {
+      g.thick_line(line_a[i % INPUT_COUNT], line_b[i % INPUT_COUNT], 5);
+    }});
+
+    cases.push_back({"triangle", solid, [tri_a, tri_b, tri_c](PicoGraphics &g, uint32_t i) {
+      g.triangle(tri_a[i % INPUT_COUNT], tri_b[i % INPUT_COUNT], tri_c[i % INPUT_COUNT]);
+    }});
+
+    cases.push_back({"polygon", solid, [star](PicoGraphics &g, uint32_t i) {
+      g.polygon(star);
+    }});
+
+    cases.push_back({"text_bitmap", [](PicoGraphics &g) {
+      g.set_pen(1);
+      g.set_font("bitmap8");
+    }, [w](PicoGraphics &g, uint32_t i) {
+      g.text(sample_text, Point(4, 4), w - 8, 2.0f);
+    }});
+
+    // laid out once and drawn from the layout every frame after
+    static TextLayout layout;
+    cases.push_back({"text_bitmap_layout", [](PicoGraphics &g) {
+      g.set_pen(1);
+      g.set_font("bitmap8");
+      layout.reset();
+    }, [w](PicoGraphics &g, uint32_t i) {
+      g.layout_text(layout, sample_text, w - 8, 2.0f);
+      g.text(layout, Point(4, 4));
+    }});
+
+    cases.push_back({"text_hershey", [](PicoGraphics &g) {
+      g.set_pen(1);
+      g.set_font("sans");
+      g.set_thickness(1);
+    }, [w](PicoGraphics &g, uint32_t i) {
+      g.text(sample_text, Point(4, 40), w - 8, 0.8f);
+    }});
+
+    cases.push_back({"text_hershey_thick", [](PicoGraphics &g) {
+      g.set_pen(1);
+      g.set_font("sans");
+      g.set_thickness(3);
+    }, [w](PicoGraphics &g, uint32_t i) {
+      g.text(sample_text, Point(4, 40), w - 8, 0.8f);
+    }});
+
+    Case sprite{"sprite", solid, [w, h, sprite_scale](PicoGraphics &g, uint32_t i) {
+      g.sprite(sheet.data(), Point(i & 15, (i >> 4) & 15), Point((i * 13) % (w - 16), (i * 7) % (h - 16)), sprite_scale, 0);
+    }};
+    sprite.pixels = sprite_pixels;
+    sprite.supported = [](const PicoGraphics &g) {
+      // sprite() is only implemented by PenRGB332
+      return g.pen_type == PicoGraphics::PEN_RGB332;
+    };
+    cases.push_back(sprite);
+
+    // copy a block of the frame buffer to another spot on the same surface
+    Case blit{"blit", solid, [w, h](PicoGraphics &g, uint32_t i) {
+      g.blit(&g, Rect(0, 0, 32, 32), Point((i * 13) % (w - 32), (i * 7) % (h - 32)));
+    }};
+    blit.pixels = 32 * 32;
+    cases.push_back(blit);
+
+    return cases;
+  }
+
+  // frame_convert targets which are implemented for each pen type
+  std::vector<std::pair<PicoGraphics::PenType, const char *>> convert_targets(PicoGraphics::PenType type) {
+    switch(type) {
+      case PicoGraphics::PEN_3BIT:   return {{PicoGraphics::PEN_P4, "p4"}};
+      case PicoGraphics::PEN_P4:     return {{PicoGraphics::PEN_RGB565, "rgb565"}, {PicoGraphics::PEN_RGB888, "rgb888"}};
+      case PicoGraphics::PEN_P8:     return {{PicoGraphics::PEN_RGB565, "rgb565"}, {PicoGraphics::PEN_RGB888, "rgb888"}};
+      case PicoGraphics::PEN_RGB332: return {{PicoGraphics::PEN_RGB565, "rgb565"}};
+      case PicoGraphics::PEN_RGB888: return {{PicoGraphics::PEN_RGB565, "rgb565"}, {PicoGraphics::PEN_RGB888, "rgb888"}};
+      case PicoGraphics::PEN_INKY7:  return {{PicoGraphics::PEN_INKY7, "inky7"}};
+      default: return {};
+    }
+  }
+
+  bool matches(const std::string &filter, const std::string &value) {
+    return filter.empty() || value.find(filter) != std::string::npos;
+  }
+
+  void report(const Options &opts, const char *pen, Size size, const std::string &name, uint64_t calls, double ns_per_call, int64_t pixels) {
+    double pixels_per_sec = ns_per_call > 0.0 ? double(pixels) * 1e9 / ns_per_call : 0.0;
+    if(opts.json) {
+      printf("{\"pen\": \"%s\", \"width\": %d, \"height\": %d, \"case\": \"%s\", \"calls\": %llu, \"ns_per_call\": %.1f, \"pixels\": %lld, \"pixels_per_sec\": %.0f}\n",
+        pen, size.w, size.h, name.c_str(), (unsigned long long)calls, ns_per_call, (long long)pixels, pixels_per_sec);
+    } else {
+      printf("%s,%d,%d,%s,%llu,%.1f,%lld,%.0f\n",
+        pen, size.w, size.h, name.c_str(), (unsigned long long)calls, ns_per_call, (long long)pixels, pixels_per_sec);
+    }
+    fflush(stdout);
+  }
+
+  // Repeat `fn` in doubling batches until at least `min_ms` has elapsed and
+  // return the mean time per call in nanoseconds.
+  double time_calls(const Options &opts, const std::function<void(uint32_t)> &fn, uint64_t &calls) {
+    using clock = std::chrono::steady_clock;
+
+    // warm up caches and any lazily built state
+    for(auto i = 0u; i < 4; i++) fn(i);
+
+    uint64_t batch = 1;
+    calls = 0;
+    double elapsed_ns = 0.0;
+    uint32_t i = 0;
+    while(elapsed_ns < opts.min_ms * 1e6) {
+      auto start = clock::now();
+      for(auto b = 0u; b < batch; b++) fn(i++);
+      auto end = clock::now();
+      elapsed_ns += std::chrono::duration<double, std::nano>(end - start).count();
+      calls += batch;
+      batch *= 2;
+    }
+    return elapsed_ns / double(calls);
+  }
+
+  void run_suite(const Options &opts, const char *pen, PicoGraphics &g, Size size) {
+    CoverageCounter counter(size.w, size.h);
+
+    for(auto &c : build_cases(size)) {
+      if(!matches(opts.case_filter, c.name)) continue;
+      if(c.supported && !c.supported(g)) continue;
+
+      int64_t pixels = c.pixels;
+      if(pixels < 0) {
+        // average coverage over the first few inputs
+        const uint32_t samples = 8;
+        uint64_t total = 0;
+        c.setup(counter);
+        for(auto i = 0u; i < samples; i++) {
+          counter.reset();
+          c.run(counter, i);
+          total += counter.count();
+        }
+        pixels = int64_t(total / samples);
+      }
+
+      g.remove_clip();
+      c.setup(g);
+      uint64_t calls = 0;
+      double ns = time_calls(opts, [&](uint32_t i) {c.run(g, i);}, calls);
+      report(opts, pen, size, c.name, calls, ns, pixels);
+    }
+
+    for(auto &target : convert_targets(g.pen_type)) {
+      std::string name = std::string("frame_convert_") + target.second;
+      if(!matches(opts.case_filter, name)) continue;
+
+      volatile size_t sink = 0;
+      uint64_t calls = 0;
+      double ns = time_calls(opts, [&](uint32_t i) {
+        g.frame_convert(target.first, [&](void *data, size_t length) {
+          if(length) sink = sink + ((uint8_t *)data)[0] + length;
+        });
+      }, calls);
+      report(opts, pen, size, name, calls, ns, int64_t(size.w) * size.h);
+    }
+  }
+
+  template<class T> void run_pen(const Options &opts, const char *pen, Size size) {
+    if(!matches(opts.pen_filter, pen)) return;
+    std::vector<uint8_t> buffer(T::buffer_size(size.w, size.h), 0);
+    T g(size.w, size.h, buffer.data());
+    // give palette types a few distinct entries to work with
+    if(g.get_palette_size() > 0) {
+      g.create_pen(0, 0, 0);
+      g.create_pen(255, 255, 255);
+      g.create_pen(255, 0, 0);
+      g.create_pen(0, 255, 0);
+      g.create_pen(0, 0, 255);
+    }
+    run_suite(opts, pen, g, size);
+  }
+
+  void run_inky7(const Options &opts, Size size) {
+    const char *pen = "Inky7";
+    if(!matches(opts.pen_filter, pen)) return;
+    MemoryDirectDriver driver(size.w, size.h);
+    PicoGraphics_PenInky7 g(size.w, size.h, driver);
+    run_suite(opts, pen, g, size);
+  }
+
+  void usage(const char *name) {
+    fprintf(stderr,
+      "usage: %s [--json] [--min-ms N] [--pen FILTER] [--case FILTER] [--size WxH]\n"
+      "\n"
+      "  --json         print JSON lines instead of CSV\n"
+      "  --min-ms N     minimum timed duration per case (default 50)\n"
+      "  --pen FILTER   only run pen types containing FILTER (eg. RGB565)\n"
+      "  --case FILTER  only run cases containing FILTER (eg. text)\n"
+      "  --size WxH     only run the given display size\n", name);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  Options opts;
+
+  for(auto i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if(arg == "--json") {
+      opts.json = true;
+    } else if(arg == "--min-ms" && has_value) {
+      opts.min_ms = atof(argv[++i]);
+    } else if(arg == "--pen" && has_value) {
+      opts.pen_filter = argv[++i];
+    } else if(arg == "--case" && has_value) {
+      opts.case_filter = argv[++i];
+    } else if(arg == "--size" && has_value) {
+      opts.size_filter = argv[++i];
+    } else {
+      usage(argv[0]);
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if(!opts.json) {
+    printf("pen,width,height,case,calls,ns_per_call,pixels,pixels_per_sec\n");
+  }
+
+  for(auto &size : sizes) {
+    std::string size_name = std::to_string(size.w) + "x" + std::to_string(size.h);
+    if(!opts.size_filter.empty() && opts.size_filter != size_name) continue;
+
+    run_pen<PicoGraphics_Pen1Bit>(opts, "1Bit", size);
+    run_pen<PicoGraphics_Pen1BitY>(opts, "1BitY", size);
+    run_pen<PicoGraphics_Pen3Bit>(opts, "3Bit", size);
+    run_pen<PicoGraphics_PenP4>(opts, "P4", size);
+    run_pen<PicoGraphics_PenP8>(opts, "P8", size);
+    run_pen<PicoGraphics_PenRGB332>(opts, "RGB332", size);
+    run_pen<PicoGraphics_PenRGB565>(opts, "RGB565", size);
+    run_pen<PicoGraphics_PenRGB888>(opts, "RGB888", size);
+    run_inky7(opts, size);
+  }
+
+  return 0;
+}
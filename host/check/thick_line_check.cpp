@@ -0,0 +1,157 @@
+// Pixel comparison of thick_line against the footprint it has always drawn.
+//
+// With the default CAP_AUTO line cap thick_line and thick Hershey text must
+// cover exactly the pixels of the original rasterizer, a t×t rectangle at
+// every step of the line. That rasterizer is kept here as the reference and
+// both are drawn over random strokes, thicknesses and clips.
+//
+// Prints the first few mismatches and exits non-zero if there are any.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+using namespace pimoroni;
+
+namespace {
+
+  const int32_t WIDTH = 160;
+  const int32_t HEIGHT = 128;
+
+  // thick_line as it was, stepping a rectangle along the line
+  void reference_thick_line(PicoGraphics &g, Point p1, Point p2, uint thickness) {
+    int32_t ht = thickness / 2;
+    int32_t t = (int32_t)thickness;
+
+    if(p1.y == p2.y) {
+      int32_t start = std::min(p1.x, p2.x);
+      int32_t end   = std::max(p1.x, p2.x);
+      g.rectangle(Rect(start, p1.y - ht, end - start, t));
+      return;
+    }
+
+    if(p1.x == p2.x) {
+      int32_t start  = std::min(p1.y, p2.y);
+      int32_t length = std::max(p1.y, p2.y) - start;
+      g.rectangle(Rect(p1.x - ht, start, t, length));
+      return;
+    }
+
+    int32_t dx = p2.x - p1.x;
+    int32_t dy = p2.y - p1.y;
+    bool shallow = std::abs(dx) > std::abs(dy);
+    if(shallow) {
+      int32_t s = std::abs(dx);
+      int32_t sx = dx < 0 ? -1 : 1;
+      int32_t sy = (dy << 16) / s;
+      int32_t x = p1.x;
+      int32_t y = p1.y << 16;
+      while(s--) {
+        g.rectangle({x - ht, (y >> 16) - ht, t, t});
+        y += sy;
+        x += sx;
+      }
+    } else {
+      int32_t s = std::abs(dy);
+      int32_t sy = dy < 0 ? -1 : 1;
+      int32_t sx = (dx << 16) / s;
+      int32_t y = p1.y;
+      int32_t x = p1.x << 16;
+      while(s--) {
+        g.rectangle({(x >> 16) - ht, y - ht, t, t});
+        y += sy;
+        x += sx;
+      }
+    }
+  }
+
+  uint32_t seed = 1;
+  int32_t rnd(int32_t lo, int32_t hi) {
+    seed = seed * 1664525u + 1013904223u;
+    return lo + int32_t((seed >> 8) % uint32_t(hi - lo + 1));
+  }
+
+  struct Surfaces {
+    PicoGraphics_PenRGB332 test{WIDTH, HEIGHT, nullptr};
+    PicoGraphics_PenRGB332 reference{WIDTH, HEIGHT, nullptr};
+
+    void reset(const Rect &clip) {
+      for(auto g : {(PicoGraphics *)&test, (PicoGraphics *)&reference}) {
+        g->remove_clip();
+        g->set_pen(0);
+        g->clear();
+        g->set_clip(clip);
+        g->set_pen(0xff);
+      }
+    }
+
+    // prints the first few mismatched pixels, returns how many there are
+    int compare(const std::string &what) {
+      const uint8_t *a = (const uint8_t *)test.frame_buffer;
+      const uint8_t *b = (const uint8_t *)reference.frame_buffer;
+      int bad = 0;
+      for(auto i = 0; i < WIDTH * HEIGHT; i++) {
+        if(a[i] != b[i]) bad++;
+      }
+      if(bad) {
+        static int reported = 0;
+        if(reported++ < 10) printf("%s: %d pixels differ\n", what.c_str(), bad);
+      }
+      return bad;
+    }
+  };
+
+}
+
+int main() {
+  Surfaces s;
+  int failures = 0, cases = 0;
+
+  for(auto i = 0; i < 6000; i++) {
+    // half short strokes, half long, a quarter of them clipped
+    int32_t reach = i & 1 ? 60 : 10;
+    Point p1(rnd(-10, WIDTH + 10), rnd(-10, HEIGHT + 10));
+    Point p2(p1.x + rnd(-reach, reach), p1.y + rnd(-reach, reach));
+    uint t = rnd(0, 12);
+    Rect clip(0, 0, WIDTH, HEIGHT);
+    if((i & 3) == 3) clip = Rect(rnd(0, WIDTH / 2), rnd(0, HEIGHT / 2), rnd(1, WIDTH / 2), rnd(1, HEIGHT / 2));
+
+    s.reset(clip);
+    s.test.thick_line(p1, p2, t);
+    reference_thick_line(s.reference, p1, p2, t);
+
+    char what[96];
+    snprintf(what, sizeof(what), "thick_line (%d, %d) - (%d, %d) t=%u", p1.x, p1.y, p2.x, p2.y, t);
+    if(s.compare(what)) failures++;
+    cases++;
+  }
+
+  // thick Hershey text draws its strokes with thick_line
+  const char *message = "The quick brown fox 0123456789 !?";
+  for(auto t = 2u; t <= 6; t++) {
+    for(auto scale : {0.5f, 1.0f, 2.0f}) {
+      for(auto angle : {0.0f, 30.0f}) {
+        s.reset(Rect(0, 0, WIDTH, HEIGHT));
+        s.test.set_font("sans");
+        s.test.set_thickness(t);
+        s.test.text(message, Point(4, 40), WIDTH * 4, scale, angle);
+
+        hershey::text(s.test.hershey_font, [&s, t](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+          reference_thick_line(s.reference, Point(x1, y1), Point(x2, y2), t);
+        }, message, 4, 40, scale, angle);
+
+        char what[96];
+        snprintf(what, sizeof(what), "hershey text t=%u s=%.1f a=%.0f", t, scale, angle);
+        if(s.compare(what)) failures++;
+        cases++;
+      }
+    }
+  }
+
+  printf("%d of %d cases match\n", cases - failures, cases);
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
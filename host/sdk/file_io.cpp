@@ -0,0 +1,41 @@
+#include <cstdio>
+#include <string>
+
+#include "libraries/pico_vector/pretty_poly.hpp"
+
+// Host implementation of pretty_poly's platform file interface, backed by stdio.
+// On device this is supplied by the MicroPython picovector module.
+
+pretty_poly::file_io::file_io(std::string_view path) {
+  FILE *f = fopen(std::string(path).c_str(), "rb");
+  if(f) {
+    fseek(f, 0, SEEK_END);
+    filesize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+  }
+  state = (void *)f;
+}
+
+pretty_poly::file_io::~file_io() {
+  if(state) fclose((FILE *)state);
+}
+
+size_t pretty_poly::file_io::seek(size_t pos) {
+  if(!state) return 0;
+  fseek((FILE *)state, pos, SEEK_SET);
+  return tell();
+}
+
+size_t pretty_poly::file_io::read(void *buf, size_t len) {
+  if(!state) return 0;
+  return fread(buf, 1, len, (FILE *)state);
+}
+
+size_t pretty_poly::file_io::tell() {
+  if(!state) return 0;
+  return ftell((FILE *)state);
+}
+
+bool pretty_poly::file_io::fail() {
+  return !state || ferror((FILE *)state);
+}
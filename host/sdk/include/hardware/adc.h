@@ -0,0 +1,38 @@
+#pragma once
+
+// Stand-in for hardware/adc.h. The ADC reads as permanently enabled and every
+// conversion returns zero.
+
+#include "pico/types.h"
+
+#define ADC_CS_EN_BITS 0x00000001u
+#define DREQ_ADC 36
+
+typedef struct {
+  uint32_t cs;
+  uint32_t result;
+  uint32_t fcs;
+  uint32_t fifo;
+  uint32_t div;
+} adc_hw_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern adc_hw_t adc_hw_instance;
+#define adc_hw (&adc_hw_instance)
+
+static inline void adc_init(void) {adc_hw->cs |= ADC_CS_EN_BITS;}
+static inline void adc_gpio_init(uint gpio) {(void)gpio;}
+static inline void adc_select_input(uint input) {(void)input;}
+static inline void adc_run(bool run) {(void)run;}
+static inline void adc_set_clkdiv(float clkdiv) {(void)clkdiv;}
+static inline uint16_t adc_read(void) {return 0;}
+static inline void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+  (void)en; (void)dreq_en; (void)dreq_thresh; (void)err_in_fifo; (void)byte_shift;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+// Stand-in for hardware/dma.h. Channels can be claimed and configured but no
+// transfers take place; code waiting on a channel returns immediately.
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum dma_channel_transfer_size {
+  DMA_SIZE_8 = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2
+};
+
+typedef struct {
+  uint32_t ctrl;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel) {
+  (void)channel;
+  dma_channel_config c = {0};
+  return c;
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {(void)c; (void)size;}
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {(void)c; (void)incr;}
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {(void)c; (void)incr;}
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {(void)c; (void)dreq;}
+static inline void channel_config_set_bswap(dma_channel_config *c, bool bswap) {(void)c; (void)bswap;}
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {(void)c; (void)chain_to;}
+
+static inline void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                         const volatile void *read_addr, uint transfer_count, bool trigger) {
+  (void)channel; (void)config; (void)write_addr; (void)read_addr; (void)transfer_count; (void)trigger;
+}
+
+static inline void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {(void)channel; (void)read_addr; (void)trigger;}
+static inline void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {(void)channel; (void)write_addr; (void)trigger;}
+static inline void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {(void)channel; (void)trans_count; (void)trigger;}
+static inline void dma_channel_start(uint channel) {(void)channel;}
+static inline void dma_channel_abort(uint channel) {(void)channel;}
+static inline bool dma_channel_is_busy(uint channel) {(void)channel; return false;}
+static inline void dma_channel_wait_for_finish_blocking(uint channel) {(void)channel;}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+#pragma once
+
+// Software model of the RP2040 interpolator, enough of it to run
+// pretty_poly's node clamping on the host. Lane behaviour follows the
+// datasheet: the accumulator is shifted, masked and optionally sign-extended,
+// then added to the lane base (or clamped between base0 and base1 when lane 0
+// is in clamp mode).
+
+#include "pico/types.h"
+
+#ifndef __cplusplus
+#error "the host interpolator model is only available to C++ code"
+#endif
+
+typedef struct {
+  uint32_t ctrl;
+} interp_config;
+
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_LSB        0u
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_BITS       0x0000001fu
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB     5u
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS    0x000003e0u
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB     10u
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS    0x00007c00u
+#define SIO_INTERP0_CTRL_LANE0_SIGNED_BITS      0x00008000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS 0x00010000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS 0x00020000u
+#define SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS     0x00040000u
+#define SIO_INTERP0_CTRL_LANE0_CLAMP_BITS       0x00400000u
+
+struct interp_hw_t {
+  uint32_t accum[2] = {0, 0};
+  uint32_t base[3] = {0, 0, 0};
+  uint32_t ctrl[2] = {0, 0};
+
+  // writes to add_raw[n] are summed into accum[n]
+  struct add_raw_t {
+    interp_hw_t *hw;
+    struct lane_t {
+      interp_hw_t *hw; int lane;
+      void operator=(uint32_t v) {hw->accum[lane] += v;}
+      void operator=(int32_t v) {hw->accum[lane] += (uint32_t)v;}
+    };
+    lane_t operator[](int lane) {return {hw, lane};}
+  } add_raw{this};
+
+  // reading peek[n] returns the lane result without side effects
+  struct peek_t {
+    interp_hw_t *hw;
+    uint32_t operator[](int lane) const {return hw->result(lane);}
+  } peek{this};
+
+  // reading pop[n] returns the lane result and writes results back into the
+  // accumulators
+  struct pop_t {
+    interp_hw_t *hw;
+    uint32_t operator[](int lane) {
+      uint32_t r0 = hw->result(0), r1 = hw->result(1), r2 = hw->result(2);
+      hw->accum[0] = (hw->ctrl[0] & SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) ? r1 : r0;
+      hw->accum[1] = (hw->ctrl[1] & SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) ? r0 : r1;
+      return lane == 0 ? r0 : (lane == 1 ? r1 : r2);
+    }
+  } pop{this};
+
+  interp_hw_t() = default;
+  interp_hw_t(const interp_hw_t &) = delete;
+  interp_hw_t &operator=(const interp_hw_t &) = delete;
+
+  uint32_t masked(int lane) const {
+    uint32_t c = ctrl[lane];
+    uint32_t input = accum[(c & SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) ? 1 - lane : lane];
+    uint32_t shift = (c & SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) >> SIO_INTERP0_CTRL_LANE0_SHIFT_LSB;
+    uint32_t lsb = (c & SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB;
+    uint32_t msb = (c & SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB;
+    uint32_t mask = (msb == 31 ? 0xffffffffu : ((1u << (msb + 1)) - 1)) & ~((1u << lsb) - 1);
+    uint32_t v = (input >> shift) & mask;
+    if((c & SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) && msb < 31 && (v & (1u << msb))) {
+      v |= ~((1u << (msb + 1)) - 1);
+    }
+    return v;
+  }
+
+  uint32_t result(int lane) const {
+    if(lane == 2) {
+      return base[2] + masked(0) + masked(1);
+    }
+    uint32_t c = ctrl[lane];
+    if(lane == 0 && (c & SIO_INTERP0_CTRL_LANE0_CLAMP_BITS)) {
+      int32_t v = (int32_t)masked(0);
+      if(c & SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) {
+        if(v < (int32_t)base[0]) return base[0];
+        if(v > (int32_t)base[1]) return base[1];
+      } else {
+        if((uint32_t)v < base[0]) return base[0];
+        if((uint32_t)v > base[1]) return base[1];
+      }
+      return (uint32_t)v;
+    }
+    uint32_t input = (c & SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS)
+      ? accum[(c & SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) ? 1 - lane : lane]
+      : masked(lane);
+    return base[lane] + input;
+  }
+};
+
+typedef struct {
+  uint32_t accum[2];
+  uint32_t base[3];
+  uint32_t ctrl[2];
+} interp_hw_save_t;
+
+extern interp_hw_t interp_hw_array[2];
+#define interp0 (&interp_hw_array[0])
+#define interp1 (&interp_hw_array[1])
+
+static inline interp_config interp_default_config(void) {
+  interp_config c = {0};
+  c.ctrl = 31u << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB;
+  return c;
+}
+
+static inline void interp_config_set_shift(interp_config *c, uint shift) {
+  c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) | (shift << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB);
+}
+
+static inline void interp_config_set_mask(interp_config *c, uint mask_lsb, uint mask_msb) {
+  c->ctrl = (c->ctrl & ~(SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS | SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS)) |
+            (mask_lsb << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
+            (mask_msb << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+}
+
+static inline void interp_config_set_flag(interp_config *c, uint32_t bits, bool set) {
+  c->ctrl = set ? (c->ctrl | bits) : (c->ctrl & ~bits);
+}
+
+static inline void interp_config_set_signed(interp_config *c, bool s) {
+  interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_SIGNED_BITS, s);
+}
+
+static inline void interp_config_set_cross_input(interp_config *c, bool cross) {
+  interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS, cross);
+}
+
+static inline void interp_config_set_cross_result(interp_config *c, bool cross) {
+  interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS, cross);
+}
+
+static inline void interp_config_set_add_raw(interp_config *c, bool add_raw) {
+  interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS, add_raw);
+}
+
+static inline void interp_config_set_clamp(interp_config *c, bool clamp) {
+  interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_CLAMP_BITS, clamp);
+}
+
+static inline void interp_set_config(interp_hw_t *interp, uint lane, interp_config *config) {
+  interp->ctrl[lane] = config->ctrl;
+}
+
+static inline void interp_save(interp_hw_t *interp, interp_hw_save_t *saver) {
+  for(int i = 0; i < 2; i++) {saver->accum[i] = interp->accum[i]; saver->ctrl[i] = interp->ctrl[i];}
+  for(int i = 0; i < 3; i++) {saver->base[i] = interp->base[i];}
+}
+
+static inline void interp_restore(interp_hw_t *interp, interp_hw_save_t *saver) {
+  for(int i = 0; i < 2; i++) {interp->accum[i] = saver->accum[i]; interp->ctrl[i] = saver->ctrl[i];}
+  for(int i = 0; i < 3; i++) {interp->base[i] = saver->base[i];}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Stand-in for hardware/irq.h, interrupts never fire on the host.
+
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+static inline void irq_set_enabled(uint num, bool enabled) {(void)num; (void)enabled;}
+static inline void irq_set_exclusive_handler(uint num, irq_handler_t handler) {(void)num; (void)handler;}
+static inline void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t priority) {(void)num; (void)handler; (void)priority;}
+static inline void irq_remove_handler(uint num, irq_handler_t handler) {(void)num; (void)handler;}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Stand-in for hardware/pio.h, only the types are provided so that headers
+// referencing PIO state machines compile on the host.
+
+#include "pico/types.h"
+
+typedef struct pio_hw_t pio_hw_t;
+typedef pio_hw_t *PIO;
+
+#define pio0 ((PIO)0)
+#define pio1 ((PIO)0)
@@ -0,0 +1,52 @@
+#pragma once
+
+// Stand-in for the parts of pico/stdlib.h used by the rendering libraries
+// when they are built natively for the host. Time is taken from the host
+// monotonic clock, everything else is a no-op.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+absolute_time_t get_absolute_time(void);
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+  return t;
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+  return (uint32_t)(t / 1000);
+}
+
+static inline uint64_t time_us_64(void) {
+  return to_us_since_boot(get_absolute_time());
+}
+
+static inline uint32_t time_us_32(void) {
+  return (uint32_t)time_us_64();
+}
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+static inline void tight_loop_contents(void) {}
+
+static inline void gpio_init(uint gpio) {(void)gpio;}
+static inline void gpio_set_dir(uint gpio, bool out) {(void)gpio; (void)out;}
+static inline void gpio_put(uint gpio, bool value) {(void)gpio; (void)value;}
+static inline bool gpio_get(uint gpio) {(void)gpio; return false;}
+static inline void gpio_pull_up(uint gpio) {(void)gpio;}
+static inline void gpio_pull_down(uint gpio) {(void)gpio;}
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// glibc already provides `uint` via <sys/types.h>, repeat it here for other
+// C libraries; an identical typedef is harmless.
+typedef unsigned int uint;
+
+typedef uint64_t absolute_time_t;
+
+#ifndef __always_inline
+#define __always_inline __attribute__((__always_inline__)) inline
+#endif
+
+#ifndef __not_in_flash_func
+#define __not_in_flash_func(func_name) func_name
+#endif
+
+#ifndef __time_critical_func
+#define __time_critical_func(func_name) func_name
+#endif
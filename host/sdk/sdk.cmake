@@ -0,0 +1,16 @@
+# Stand-in pico-sdk for host builds.
+#
+# Provides interface targets with the same names as the pico-sdk libraries
+# that our rendering code links against, so the library .cmake files can be
+# included unmodified.
+add_library(pico_host_sdk STATIC
+    ${CMAKE_CURRENT_LIST_DIR}/sdk.cpp
+)
+
+target_include_directories(pico_host_sdk PUBLIC ${CMAKE_CURRENT_LIST_DIR}/include)
+target_compile_definitions(pico_host_sdk PUBLIC PICO_BUILD=1 PICO_ON_DEVICE=0 __LINUX__=1)
+
+foreach(LIB pico_stdlib hardware_interp hardware_dma hardware_pio hardware_adc hardware_irq hardware_spi hardware_pwm)
+  add_library(${LIB} INTERFACE)
+  target_link_libraries(${LIB} INTERFACE pico_host_sdk)
+endforeach()
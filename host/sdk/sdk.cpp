@@ -0,0 +1,47 @@
+#include <time.h>
+
+#include "pico/stdlib.h"
+#include "hardware/interp.h"
+#include "hardware/dma.h"
+#include "hardware/adc.h"
+
+interp_hw_t interp_hw_array[2];
+
+adc_hw_t adc_hw_instance = {};
+
+static uint32_t dma_claimed = 0;
+
+extern "C" {
+
+  absolute_time_t get_absolute_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (absolute_time_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000u;
+  }
+
+  void sleep_us(uint64_t us) {
+    struct timespec ts;
+    ts.tv_sec = us / 1000000u;
+    ts.tv_nsec = (us % 1000000u) * 1000u;
+    nanosleep(&ts, nullptr);
+  }
+
+  void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+  }
+
+  int dma_claim_unused_channel(bool required) {
+    for(int i = 0; i < 12; i++) {
+      if(!(dma_claimed & (1u << i))) {
+        dma_claimed |= (1u << i);
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  void dma_channel_unclaim(uint channel) {
+    dma_claimed &= ~(1u << channel);
+  }
+
+}
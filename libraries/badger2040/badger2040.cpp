@@ -387,9 +387,9 @@ namespace pimoroni {
       _font = nullptr;
     } else {
       // check that font exists and assign it
-      if(hershey::fonts.find(name) != hershey::fonts.end()) {
+      if(hershey::has_font(name)) {
         _bitmap_font = nullptr;
-        _font = hershey::fonts[name];
+        _font = hershey::font(name);
       }
     }
   }
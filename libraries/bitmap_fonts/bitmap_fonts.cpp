@@ -42,9 +42,11 @@ namespace bitmap {
     return text_width;
   }
 
-  void character(const font_t *font, rect_func rectangle, const char c, const int32_t x, const int32_t y, const uint8_t scale, int32_t rotation, unicode_sorta::codepage_t codepage) {
+  // Fills `columns` with the glyph for `c` and any accent, returning how
+  // many columns it is wide (at most max_glyph_width)
+  uint8_t glyph(const font_t *font, const char c, uint32_t *columns, unicode_sorta::codepage_t codepage) {
     if(c < 32 || c > 127 + 64) { // + 64 char remappings defined in unicode_sorta.hpp
-      return;
+      return 0;
     }
 
     uint8_t char_index = c;
@@ -88,18 +90,13 @@ namespace bitmap {
     // Note this magic number is relative to the start of printable ASCII chars.
     uint8_t accent_offset = char_index < 65 ? offset_upper : offset_lower;
 
-    // Offset our y position to account for our column canvas being 32 pixels
-    // this gives us 8 "pixels" of headroom above the letters for diacritic marks
-    int font_offset = (8 * scale);
-
     // Iterate through each horizontal column of font (and accent) data
-    for(uint8_t cx = 0; cx < font->widths[char_index]; cx++) {
+    uint8_t width = std::min(font->widths[char_index], uint8_t(max_glyph_width));
+    for(uint8_t cx = 0; cx < width; cx++) {
       // Our maximum bitmap font height will be 16 pixels
       // give ourselves a 32 pixel high canvas in which to plot the char and accent.
       // We shift the char down 8 pixels to make room for an accent above.
-      uint32_t data = *d << 8;
-
-      int32_t o_x = cx * scale;
+      uint32_t data = *d << glyph_offset;
 
       // For fonts that are taller than 8 pixels (up to 16) they need two bytes
       if(two_bytes_per_column) {
@@ -113,41 +110,58 @@ namespace bitmap {
         data |= *a << accent_offset;
       }
 
-      // Draw the 32 pixel column
-      for(uint8_t cy = 0; cy < 32; cy++) {
-        if((1U << cy) & data) {
-          int32_t o_y = cy * scale;
-          int32_t px = 0;
-          int32_t py = 0;
-          switch (rotation) {
-            case 0:
-              px = x + o_x;
-              py = y - font_offset + o_y;
-              break;
-            case 90:
-              px = x + font_offset - o_y;
-              py = y + o_x;
-              break;
-            case 180:
-              px = x - o_x;
-              py = y + font_offset - o_y;
-              break;
-            case 270:
-              px = x - font_offset + o_y;
-              py = y - o_x;
-              break;
-          }
-          rectangle(px, py, scale, scale);
-        }
-      }
+      columns[cx] = data;
 
       // Move to the next columns of char and accent data
       d++;
       a++;
     }
+
+    return width;
   }
 
-  void text(const font_t *font, rect_func rectangle, const std::string_view &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale, const uint8_t letter_spacing, bool fixed_width, int32_t rotation) {
+  void character(const font_t *font, rect_func rectangle, const char c, const int32_t x, const int32_t y, const uint8_t scale, int32_t rotation, unicode_sorta::codepage_t codepage) {
+    uint32_t columns[max_glyph_width];
+    uint8_t width = glyph(font, c, columns, codepage);
+
+    // Offset our y position to account for our column canvas being 32 pixels
+    // this gives us 8 "pixels" of headroom above the letters for diacritic marks
+    int font_offset = (glyph_offset * scale);
+
+    for(uint8_t cx = 0; cx < width; cx++) {
+      uint32_t data = columns[cx];
+      int32_t o_x = cx * scale;
+
+      // Draw each run of set pixels down the column as one rectangle
+      while(data) {
+        int32_t top = __builtin_ctz(data);
+        uint32_t rest = ~(data >> top);
+        int32_t run = rest ? __builtin_ctz(rest) : 32 - top;
+        data = top + run < 32 ? data & (~0U << (top + run)) : 0;
+
+        int32_t o_y = top * scale;
+        int32_t l = run * scale;
+        switch (rotation) {
+          case 0:
+            rectangle(x + o_x, y - font_offset + o_y, scale, l);
+            break;
+          case 90:
+            rectangle(x + font_offset - o_y - l + scale, y + o_x, l, scale);
+            break;
+          case 180:
+            rectangle(x - o_x, y + font_offset - o_y - l + scale, scale, l);
+            break;
+          case 270:
+            rectangle(x - font_offset + o_y, y - o_x, l, scale);
+            break;
+        }
+      }
+    }
+  }
+
+  // Works out where each printable character of `t` goes, wrapping words
+  // at `wrap`, and passes them to `character`
+  void layout_text(const font_t *font, char_func character, const std::string_view &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale, const uint8_t letter_spacing, bool fixed_width, int32_t rotation) {
     uint32_t char_offset = 0;
     uint32_t line_offset = 0; // line (if wrapping) offset
     unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195;
@@ -208,16 +222,16 @@ namespace bitmap {
         } else {
           switch(rotation) {
             case 0:
-              character(font, rectangle, t[j], x + char_offset, y + line_offset, scale, rotation, codepage);
+              character(t[j], x + char_offset, y + line_offset, codepage);
               break;
             case 90:
-              character(font, rectangle, t[j], x - line_offset, y + char_offset, scale, rotation, codepage);
+              character(t[j], x - line_offset, y + char_offset, codepage);
               break;
             case 180:
-              character(font, rectangle, t[j], x - char_offset, y - line_offset, scale, rotation, codepage);
+              character(t[j], x - char_offset, y - line_offset, codepage);
               break;
             case 270:
-              character(font, rectangle, t[j], x + line_offset, y - char_offset, scale, rotation, codepage);
+              character(t[j], x + line_offset, y - char_offset, codepage);
               break;
           }
           char_offset += measure_character(font, t[j], scale, codepage, fixed_width);
@@ -230,4 +244,10 @@ namespace bitmap {
       i = next_break += 1;
     }
   }
+
+  void text(const font_t *font, rect_func rectangle, const std::string_view &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale, const uint8_t letter_spacing, bool fixed_width, int32_t rotation) {
+    layout_text(font, [font, &rectangle, scale, rotation](const char c, int32_t x, int32_t y, unicode_sorta::codepage_t codepage) {
+      character(font, rectangle, c, x, y, scale, rotation, codepage);
+    }, t, x, y, wrap, scale, letter_spacing, fixed_width, rotation);
+  }
 }
\ No newline at end of file
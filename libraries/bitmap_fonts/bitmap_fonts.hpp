@@ -18,10 +18,19 @@ namespace bitmap {
   };
 
   typedef std::function<void(int32_t x, int32_t y, int32_t w, int32_t h)> rect_func;
+  typedef std::function<void(const char c, int32_t x, int32_t y, unicode_sorta::codepage_t codepage)> char_func;
+
+  // Glyph columns are 32 pixel tall, bit 0 at the top. The character sits
+  // 8 pixels down, leaving room above for any accent.
+  const int glyph_offset = 8;
+  const int max_glyph_width = 32;
 
   int32_t measure_character(const font_t *font, const char c, const uint8_t scale, unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195, bool fixed_width = false);
   int32_t measure_text(const font_t *font, const std::string_view &t, const uint8_t scale = 2, const uint8_t letter_spacing = 1, bool fixed_width = false);
 
+  uint8_t glyph(const font_t *font, const char c, uint32_t *columns, unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195);
+
   void character(const font_t *font, rect_func rectangle, const char c, const int32_t x, const int32_t y, const uint8_t scale = 2, int32_t rotation = 0, unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195);
+  void layout_text(const font_t *font, char_func character, const std::string_view &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale = 2, const uint8_t letter_spacing = 1, bool fixed_width = false, int32_t rotation = 0);
   void text(const font_t *font, rect_func rectangle, const std::string_view &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale = 2, const uint8_t letter_spacing = 1, bool fixed_width = false, int32_t rotation = 0);
 }
\ No newline at end of file
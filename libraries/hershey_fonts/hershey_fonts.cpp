@@ -3,36 +3,17 @@
 #include <cmath>
 
 namespace hershey {
-#ifndef MICROPY_BUILD_TYPE
-  std::map<std::string, const font_t*> fonts = {
-    { "sans",         &futural },
-    //{ "sans_bold",    &futuram },
-    { "gothic",       &gothgbt },
-    //{ "cursive_bold", &scriptc },
-    { "cursive",      &scripts },
-    { "serif_italic", &timesi  },
-    { "serif",        &timesr  },
-    //{ "serif_bold",   &timesrb }
-  };
-#endif
-
   bool has_font(std::string_view font) {
-    if(font == "sans"
-    || font == "gothic"
-    || font == "cursive"
-    || font == "serif_italic"
-    || font == "serif") {
-      return true;
+    for(auto &entry : fonts) {
+      if(entry.name == font) return true;
     }
     return false;
   }
 
   const font_t* font(std::string_view font) {
-    if(font == "sans") return &futural;
-    else if(font == "gothic") return &gothgbt;
-    else if(font == "cursive") return &scripts;
-    else if(font == "serif_italic") return &timesi;
-    else if(font == "serif") return &timesr;
+    for(auto &entry : fonts) {
+      if(entry.name == font) return entry.font;
+    }
     return &futural;
   }
 
@@ -71,7 +52,54 @@ namespace hershey {
     return width;
   }
 
-  int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a) {
+  // sine and cosine as 16.16 fixed point
+  static void fixed_sincos(float a, int32_t &as, int32_t &ac) {
+    a = deg2rad(a);
+    as = lroundf(sinf(a) * 65536.0f);
+    ac = lroundf(cosf(a) * 65536.0f);
+  }
+
+  // a fixed point value rounded half up towards zero, as converting
+  // `v + 0.5f` to an int would
+  static inline int32_t fixed_round(int32_t v) {
+    return (v + 32768) / 65536;
+  }
+
+  const GlyphCache::Glyph *GlyphCache::find(const font_t *font, unsigned char c, float s, float a) {
+    if(slots.empty()) return nullptr;
+    const Glyph &g = slots[slot(font, c)];
+    if(g.font == font && g.c == c && g.s == s && g.a == a) return &g;
+    return nullptr;
+  }
+
+  GlyphCache::Glyph *GlyphCache::add(const font_t *font, unsigned char c, float s, float a, uint32_t count) {
+    if(count > MAX_LINES) return nullptr;
+    if(pool.size() + count > MAX_LINES) clear();
+    if(slots.empty()) slots.resize(SLOTS);
+
+    Glyph &g = slots[slot(font, c)];
+    g.font = font;
+    g.c = c;
+    g.s = s;
+    g.a = a;
+    g.offset = pool.size();
+    g.count = count;
+    pool.resize(g.offset + count);
+    return &g;
+  }
+
+  void GlyphCache::finish(Glyph *glyph, uint32_t count, int32_t width) {
+    glyph->count = count;
+    glyph->width = width;
+    pool.resize(glyph->offset + count);
+  }
+
+  void GlyphCache::clear() {
+    for(auto &g : slots) g.font = nullptr;
+    pool.clear();
+  }
+
+  int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a, GlyphCache *cache) {
     const font_glyph_t *gd = glyph_data(font, c);
 
     // if glyph data not found (id too great) then skip
@@ -79,56 +107,80 @@ namespace hershey {
       return 0;
     }
 
-    a = deg2rad(a);
-    float as = sin(a);
-    float ac = cos(a);
-
-    const int8_t *pv = gd->vertices;
-    int8_t cx = (*pv++) * s;
-    int8_t cy = (*pv++) * s;
-    bool pen_down = true;
-
-    for(uint32_t i = 1; i < gd->vertex_count; i++) {
-      if(pv[0] == -128 && pv[1] == -128) {
-        pen_down = false;
-        pv += 2;
-      }else{
-        int8_t nx = (*pv++) * s;
-        int8_t ny = (*pv++) * s;
-
-        int rcx = (cx * ac - cy * as) + 0.5f;
-        int rcy = (cx * as + cy * ac) + 0.5f;
-
-        int rnx = (nx * ac - ny * as) + 0.5f;
-        int rny = (nx * as + ny * ac) + 0.5f;
-
-        if(pen_down) {
-          line(rcx + x, rcy + y, rnx + x, rny + y);
+    const GlyphCache::Glyph *cached = cache ? cache->find(font, c, s, a) : nullptr;
+
+    if(!cached) {
+      // lines go to the cache if there is one, otherwise straight out
+      GlyphCache::Glyph *adding = cache ? cache->add(font, c, s, a, gd->vertex_count) : nullptr;
+      GlyphCache::Line *out = adding ? cache->lines(adding) : nullptr;
+      uint32_t count = 0;
+
+      // scale and rotate each vertex in 16.16 fixed point, the scaled vertex
+      // is truncated to whole pixels before it's rotated
+      int32_t as, ac;
+      fixed_sincos(a, as, ac);
+      int32_t fs = lroundf(s * 65536.0f);
+
+      const int8_t *pv = gd->vertices;
+      int32_t cx = ((*pv++) * fs) / 65536;
+      int32_t cy = ((*pv++) * fs) / 65536;
+      int32_t rcx = fixed_round(cx * ac - cy * as);
+      int32_t rcy = fixed_round(cx * as + cy * ac);
+      bool pen_down = true;
+
+      for(uint32_t i = 1; i < gd->vertex_count; i++) {
+        if(pv[0] == -128 && pv[1] == -128) {
+          pen_down = false;
+          pv += 2;
+        }else{
+          int32_t nx = ((*pv++) * fs) / 65536;
+          int32_t ny = ((*pv++) * fs) / 65536;
+
+          int32_t rnx = fixed_round(nx * ac - ny * as);
+          int32_t rny = fixed_round(nx * as + ny * ac);
+
+          if(pen_down) {
+            if(out) {
+              out[count++] = {int16_t(rcx), int16_t(rcy), int16_t(rnx), int16_t(rny)};
+            } else {
+              line(rcx + x, rcy + y, rnx + x, rny + y);
+            }
+          }
+
+          rcx = rnx;
+          rcy = rny;
+          pen_down = true;
         }
-
-        cx = nx;
-        cy = ny;
-        pen_down = true;
       }
+
+      int32_t width = gd->width * s;
+      if(!adding) return width;
+
+      cache->finish(adding, count, width);
+      cached = adding;
     }
 
-    return gd->width * s;
+    const GlyphCache::Line *l = cache->lines(cached);
+    for(auto i = 0u; i < cached->count; i++, l++) {
+      line(l->x1 + x, l->y1 + y, l->x2 + x, l->y2 + y);
+    }
+    return cached->width;
   }
 
-  void text(const font_t* font, line_func line, std::string_view message, int32_t x, int32_t y, float s, float a) {
+  void text(const font_t* font, line_func line, std::string_view message, int32_t x, int32_t y, float s, float a, GlyphCache *cache) {
     int32_t cx = x;
     int32_t cy = y;
 
     int32_t ox = 0;
 
-    float as = sin(deg2rad(a));
-    float ac = cos(deg2rad(a));
+    int32_t as, ac;
+    fixed_sincos(a, as, ac);
 
     for(auto &c : message) {
-      int rcx = (ox * ac) + 0.5f;
-      int rcy = (ox * as) + 0.5f;
+      int rcx = fixed_round(ox * ac);
+      int rcy = fixed_round(ox * as);
 
-      ox += glyph(font, line, c, cx + rcx, cy + rcy, s, a);
+      ox += glyph(font, line, c, cx + rcx, cy + rcy, s, a, cache);
     }
   }
 }
\ No newline at end of file
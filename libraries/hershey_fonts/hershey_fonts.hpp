@@ -1,5 +1,8 @@
-#include <map>
+#pragma once
+
 #include <string>
+#include <string_view>
+#include <vector>
 #include <functional>
 #include <cstdint>
 
@@ -38,16 +41,75 @@ namespace hershey {
   extern const int8_t timesrb_vertices[7994];
   extern const font_t timesrb;
 
+  struct font_entry_t {
+    std::string_view name;
+    const font_t *font;
+  };
+
+  constexpr font_entry_t fonts[] = {
+    { "sans",         &futural },
+    //{ "sans_bold",    &futuram },
+    { "gothic",       &gothgbt },
+    //{ "cursive_bold", &scriptc },
+    { "cursive",      &scripts },
+    { "serif_italic", &timesi  },
+    { "serif",        &timesr  },
+    //{ "serif_bold",   &timesrb }
+  };
+
   typedef std::function<void(int32_t x1, int32_t y1, int32_t x2, int32_t y2)> line_func;
 
-  extern std::map<std::string, const font_t*> fonts;
+  // Recently drawn glyphs as lines already scaled, rotated and rounded to
+  // whole pixels, ready to be moved to where they're drawn. Glyphs are
+  // found by font, character, scale and angle in a small table indexed by
+  // character, with a slot for each ASCII character of a font, and their
+  // lines are kept in a shared pool. When the pool fills everything is
+  // dropped and the cache starts over, so it never holds more than
+  // MAX_LINES lines.
+  class GlyphCache {
+    public:
+      static const uint32_t SLOTS = 128;
+      static const uint32_t MAX_LINES = 1024;
+
+      struct Line {
+        int16_t x1, y1, x2, y2;
+      };
+
+      struct Glyph {
+        const font_t *font = nullptr;
+        float s, a;
+        unsigned char c;
+        uint16_t offset, count;
+        int32_t width;
+      };
+
+      // the cached glyph, or nullptr if it needs adding
+      const Glyph *find(const font_t *font, unsigned char c, float s, float a);
+      // makes room for a glyph of up to `count` lines to be written to
+      // lines(), returning nullptr if it's too big to cache
+      Glyph *add(const font_t *font, unsigned char c, float s, float a, uint32_t count);
+      // trims an added glyph to the lines actually written
+      void finish(Glyph *glyph, uint32_t count, int32_t width);
+
+      Line *lines(const Glyph *glyph) {return pool.data() + glyph->offset;}
+
+      void clear();
+
+    private:
+      std::vector<Glyph> slots;
+      std::vector<Line> pool;
+
+      static uint32_t slot(const font_t *font, unsigned char c) {
+        return (c ^ (uintptr_t(font) >> 4)) & (SLOTS - 1);
+      }
+  };
 
   inline float deg2rad(float degrees);
   const font_glyph_t* glyph_data(const font_t* font, unsigned char c);
   int32_t measure_glyph(const font_t* font, unsigned char c, float s);
   int32_t measure_text(const font_t* font, std::string_view message, float s);
-  int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a);
-  void text(const font_t* font, line_func line, std::string_view message, int32_t x, int32_t y, float s, float a);
+  int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a, GlyphCache *cache = nullptr);
+  void text(const font_t* font, line_func line, std::string_view message, int32_t x, int32_t y, float s, float a, GlyphCache *cache = nullptr);
 
   bool has_font(std::string_view font);
   const font_t* font(std::string_view font);
@@ -9,6 +9,12 @@ endif()
 add_library(pico_graphics 
     ${CMAKE_CURRENT_LIST_DIR}/types.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_blit.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_dither.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_palette.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_sprites.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_text.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_display_list.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_1bit.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_1bitY.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_3bit.cpp
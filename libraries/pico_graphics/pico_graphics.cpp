@@ -8,15 +8,23 @@ namespace pimoroni {
   int PicoGraphics::reset_pen(uint8_t i) {return -1;};
   int PicoGraphics::create_pen(uint8_t r, uint8_t g, uint8_t b) {return -1;};
   int PicoGraphics::create_pen_hsv(float h, float s, float v){return -1;};
+  uint PicoGraphics::get_pen() {return 0;};
+  RGB PicoGraphics::pen_to_rgb(uint pen) {return RGB();};
+  uint PicoGraphics::rgb_to_pen(const RGB &c) {return 0;};
+  const void *PicoGraphics::pixel_layout() {return nullptr;};
   void PicoGraphics::set_pixel_alpha(const Point &p, const uint8_t a) {};
   void PicoGraphics::set_pixel_dither(const Point &p, const RGB &c) {};
   void PicoGraphics::set_pixel_dither(const Point &p, const RGB565 &c) {};
   void PicoGraphics::set_pixel_dither(const Point &p, const uint8_t &c) {};
-  void PicoGraphics::frame_convert(PenType type, conversion_callback_func callback) {};
+  void PicoGraphics::frame_convert(PenType type, conversion_callback_func callback) {
+    frame_convert_rect(type, bounds, callback);
+  };
+  void PicoGraphics::frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) {};
   void PicoGraphics::sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent) {};
 
   int PicoGraphics::get_palette_size() {return 0;}
   RGB* PicoGraphics::get_palette() {return nullptr;}
+  int PicoGraphics::closest_pen(const RGB &c) {return c.closest(get_palette(), get_palette_size());}
   bool PicoGraphics::supports_alpha_blend() {return false;}
 
   void PicoGraphics::set_dimensions(int width, int height) {
@@ -56,12 +64,103 @@ namespace pimoroni {
     thickness = t;
   }
 
+  void PicoGraphics::set_line_cap(LineCap cap) {
+    line_cap = cap;
+  }
+
+  void PicoGraphics::set_convert_buffer(void *buffer, size_t length) {
+    convert_buffer = buffer;
+    convert_buffer_size = length;
+  }
+
   void PicoGraphics::set_clip(const Rect &r) {
     clip = bounds.intersection(r);
+    if(display_list) record_command(DisplayList::CLIP, clip.y, clip.y, clip.x, clip.y, clip.w, clip.h);
   }
 
   void PicoGraphics::remove_clip() {
     clip = bounds;
+    if(display_list) record_command(DisplayList::CLIP, clip.y, clip.y, clip.x, clip.y, clip.w, clip.h);
+  }
+
+  // bounding box of two non-empty rectangles
+  static Rect bounding_rect(const Rect &a, const Rect &b) {
+    return Rect(
+      Point(std::min(a.x, b.x), std::min(a.y, b.y)),
+      Point(std::max(a.x + a.w, b.x + b.w), std::max(a.y + a.h, b.y + b.h)));
+  }
+
+  static bool encloses(const Rect &outer, const Rect &inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+  }
+
+  // pixels that merging two areas would mark as damaged when they aren't
+  static int32_t merge_waste(const Rect &a, const Rect &b) {
+    Rect u = bounding_rect(a, b);
+    Rect o = a.intersection(b);
+    int32_t overlap = o.empty() ? 0 : o.w * o.h;
+    return u.w * u.h - (a.w * a.h + b.w * b.h - overlap);
+  }
+
+  // each damaged area costs a window setup on the display, so areas that
+  // are close are merged even if that marks a few more pixels
+  constexpr int32_t DAMAGE_MERGE_SLACK = 256;
+
+  static bool worth_merging(const Rect &a, const Rect &b) {
+    return merge_waste(a, b) <= std::max(DAMAGE_MERGE_SLACK, (a.w * a.h + b.w * b.h) / 4);
+  }
+
+  void PicoGraphics::add_damage(const Rect &r) {
+    Rect d = r.intersection(bounds);
+    if(d.empty()) return;
+
+    // nothing to do if already damaged, most drawing lands in the area the
+    // previous primitive added so check the newest first
+    for(auto i = damage_count; i > 0; i--) {
+      if(encloses(damage[i - 1], d)) return;
+    }
+
+    // absorb any areas it's worth merging with, the merged area may then be
+    // worth merging with an area that was skipped so start again
+    for(auto i = 0u; i < damage_count;) {
+      if(worth_merging(damage[i], d)) {
+        d = bounding_rect(damage[i], d);
+        damage[i] = damage[--damage_count];
+        i = 0;
+      } else {
+        i++;
+      }
+    }
+
+    if(damage_count < MAX_DAMAGE) {
+      damage[damage_count++] = d;
+      return;
+    }
+
+    // the list is full, merge the new area into the cheapest of the others
+    // or merge the two cheapest others to make room
+    uint best_i = 0, best_j = MAX_DAMAGE;
+    int32_t best = INT32_MAX;
+    for(auto i = 0u; i < MAX_DAMAGE; i++) {
+      int32_t w = merge_waste(damage[i], d);
+      if(w < best) {best = w; best_i = i; best_j = MAX_DAMAGE;}
+      for(auto j = i + 1; j < MAX_DAMAGE; j++) {
+        w = merge_waste(damage[i], damage[j]);
+        if(w < best) {best = w; best_i = i; best_j = j;}
+      }
+    }
+
+    if(best_j == MAX_DAMAGE) {
+      damage[best_i] = bounding_rect(damage[best_i], d);
+    } else {
+      damage[best_i] = bounding_rect(damage[best_i], damage[best_j]);
+      damage[best_j] = d;
+    }
+  }
+
+  void PicoGraphics::clear_damage() {
+    damage_count = 0;
   }
   
   void PicoGraphics::clear() {
@@ -69,11 +168,18 @@ namespace pimoroni {
   }
 
   void PicoGraphics::pixel(const Point &p) {
+    if(display_list) {record_command(DisplayList::PIXEL, p.y, p.y, p.x, p.y); return;}
     if(!clip.contains(p)) return;
+    add_damage(Rect(p.x, p.y, 1, 1));
     set_pixel(p);
   }
 
   void PicoGraphics::pixel_span(const Point &p, int32_t l) {
+    if(display_list) {
+      if(l > 0) record_command(DisplayList::PIXEL_SPAN, p.y, p.y, p.x, p.y, l);
+      return;
+    }
+
     // check if span in bounds
     if( p.x + l < clip.x || p.x >= clip.x + clip.w ||
         p.y     < clip.y || p.y >= clip.y + clip.h) return;
@@ -83,30 +189,49 @@ namespace pimoroni {
     if(clipped.x     <  clip.x)           {l += clipped.x - clip.x; clipped.x = clip.x;}
     if(clipped.x + l >= clip.x + clip.w)  {l  = clip.x + clip.w - clipped.x;}
 
+    // nothing left to draw (zero length spans would underflow in the pens)
+    if(l <= 0) return;
+
     Point dest(clipped.x, clipped.y);
+    add_damage(Rect(dest.x, dest.y, l, 1));
     set_pixel_span(dest, l);
   }
 
+  void PicoGraphics::set_pixel_rect(const Rect &r) {
+    Point dest(r.x, r.y);
+    for(auto h = r.h; h > 0; h--) {
+      // draw span of pixels for this row
+      set_pixel_span(dest, r.w);
+      // move to next scanline
+      dest.y++;
+    }
+  }
+
   void PicoGraphics::rectangle(const Rect &r) {
+    if(display_list) {
+      if(!r.empty()) record_command(DisplayList::RECTANGLE, r.y, r.y + r.h - 1, r.x, r.y, r.w, r.h);
+      return;
+    }
+
     // clip and/or discard depending on rectangle visibility
     Rect clipped = r.intersection(clip);
 
     if(clipped.empty()) return;
 
-    Point dest(clipped.x, clipped.y);
-    while(clipped.h--) {
-      // draw span of pixels for this row
-      set_pixel_span(dest, clipped.w);
-      // move to next scanline
-      dest.y++;
-    }
+    add_damage(clipped);
+    set_pixel_rect(clipped);
   }
 
   void PicoGraphics::circle(const Point &p, int32_t radius) {
+    if(display_list) {record_command(DisplayList::CIRCLE, p.y - radius, p.y + radius, p.x, p.y, radius); return;}
+
     // circle in screen bounds?
     Rect bounds = Rect(p.x - radius, p.y - radius, radius * 2, radius * 2);
     if(!bounds.intersects(clip)) return;
 
+    // damage the whole circle up front, each span is then already covered
+    add_damage(Rect(p.x - radius, p.y - radius, radius * 2 + 1, radius * 2 + 1).intersection(clip));
+
     int ox = radius, oy = 0, err = -radius;
     while (ox >= oy)
     {
@@ -131,26 +256,62 @@ namespace pimoroni {
   }
 
   void PicoGraphics::character(const char c, const Point &p, float s, float a) {
+    if(display_list) {record_text(DisplayList::CHARACTER, std::string_view(&c, 1), p, 0, s, a, 0, false); return;}
+
     if (bitmap_font) {
-      bitmap::character(bitmap_font, [this](int32_t x, int32_t y, int32_t w, int32_t h) {
-        rectangle(Rect(x, y, w, h));
-      }, c, p.x, p.y, std::max(1.0f, s), int32_t(a) % 360);
+      bitmap_character(c, p, std::max(1.0f, s), int32_t(a) % 360, unicode_sorta::PAGE_195);
       return;
     }
 
     if (hershey_font) {
       hershey::glyph(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
         line(Point(x1, y1), Point(x2, y2));
-      }, c, p.x, p.y, s, a);
+      }, c, p.x, p.y, s, a, &glyph_cache);
       return;
     }
   }
 
+  // Unrotated characters that the clip doesn't cut through are drawn by
+  // set_pixel_glyph(), the rest as a rectangle per run of pixels down each
+  // column.
+  void PicoGraphics::bitmap_character(const char c, const Point &p, uint8_t scale, int32_t rotation, unicode_sorta::codepage_t codepage) {
+    auto rect = [this](int32_t x, int32_t y, int32_t w, int32_t h) {
+      rectangle(Rect(x, y, w, h));
+    };
+    if(rotation != 0) {
+      bitmap::character(bitmap_font, rect, c, p.x, p.y, scale, rotation, codepage);
+      return;
+    }
+
+    uint32_t columns[bitmap::max_glyph_width];
+    uint8_t width = bitmap::glyph(bitmap_font, c, columns, codepage);
+
+    uint32_t used = 0;
+    for(auto cx = 0u; cx < width; cx++) used |= columns[cx];
+    if(!used) return;
+
+    Point top(p.x, p.y - bitmap::glyph_offset * scale);
+    int32_t first = __builtin_ctz(used), last = 31 - __builtin_clz(used);
+    Rect box(top.x, top.y + first * scale, width * scale, (last - first + 1) * scale);
+    if(!box.intersects(clip)) return;
+    if(!clip.contains(box)) {
+      bitmap::character(bitmap_font, rect, c, p.x, p.y, scale, rotation, codepage);
+      return;
+    }
+
+    add_damage(box);
+    set_pixel_glyph(top, columns, width, scale);
+  }
+
   void PicoGraphics::text(const std::string_view &t, const Point &p, int32_t wrap, float s, float a, uint8_t letter_spacing, bool fixed_width) {
+    if(display_list) {record_text(DisplayList::TEXT, t, p, wrap, s, a, letter_spacing, fixed_width); return;}
+
     if (bitmap_font) {
-      bitmap::text(bitmap_font, [this](int32_t x, int32_t y, int32_t w, int32_t h) {
-        rectangle(Rect(x, y, w, h));
-      }, t, p.x, p.y, wrap, std::max(1.0f, s), letter_spacing, fixed_width, int32_t(a) % 360);
+      uint8_t scale = std::max(1.0f, s);
+      int32_t rotation = int32_t(a) % 360;
+      bitmap::layout_text(bitmap_font, [this, scale, rotation](const char c, int32_t x, int32_t y, unicode_sorta::codepage_t codepage) {
+        bitmap_character(c, Point(x, y), scale, rotation, codepage);
+      }, t, p.x, p.y, wrap, scale, letter_spacing, fixed_width, rotation);
       return;
     }
 
@@ -158,11 +319,11 @@ namespace pimoroni {
       if(thickness == 1) {
         hershey::text(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
           line(Point(x1, y1), Point(x2, y2));
-        }, t, p.x, p.y, s, a);
+        }, t, p.x, p.y, s, a, &glyph_cache);
       } else {
         hershey::text(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
           thick_line(Point(x1, y1), Point(x2, y2), thickness);
-        }, t, p.x, p.y, s, a);
+        }, t, p.x, p.y, s, a, &glyph_cache);
       }
       return;
     }
@@ -182,7 +343,38 @@ namespace pimoroni {
     return (p1.y == p2.y && p1.x > p2.x) || (p1.y < p2.y);
   }
 
+  // Steps floor(n / d) exactly as n changes by a constant amount each
+  // scanline, keeping the remainder rather than dividing on every row
+  struct EdgeStepper {
+    int32_t q = 0, r = 0, d = 1, dq = 0, dr = 0;
+
+    static int32_t floor_div(int32_t n, int32_t d) {
+      int32_t q = n / d;
+      return (n % d != 0 && (n < 0)) ? q - 1 : q;
+    }
+
+    EdgeStepper() = default;
+    EdgeStepper(int32_t n, int32_t d, int32_t step) : d(d) {
+      q = floor_div(n, d);
+      r = n - q * d;
+      dq = floor_div(step, d);
+      dr = step - dq * d;
+    }
+
+    void next() {
+      q += dq;
+      r += dr;
+      if(r >= d) {r -= d; q++;}
+    }
+  };
+
   void PicoGraphics::triangle(Point p1, Point p2, Point p3) {
+    if(display_list) {
+      Point points[3] = {p1, p2, p3};
+      record_points(DisplayList::TRIANGLE, points, 3);
+      return;
+    }
+
     Rect triangle_bounds(
       Point(std::min(p1.x, std::min(p2.x, p3.x)), std::min(p1.y, std::min(p2.y, p3.y))),
       Point(std::max(p1.x, std::max(p2.x, p3.x)), std::max(p1.y, std::max(p2.y, p3.y))));
@@ -195,6 +387,8 @@ namespace pimoroni {
       return;
     }
 
+    add_damage(triangle_bounds);
+
     // fix "winding" of vertices if needed
     int32_t winding = orient2d(p1, p2, p3);
     if (winding < 0) {
@@ -207,138 +401,365 @@ namespace pimoroni {
     int8_t bias1 = is_top_left(p3, p1) ? 0 : -1;
     int8_t bias2 = is_top_left(p1, p2) ? 0 : -1;
 
-    int32_t a01 = p1.y - p2.y;
-    int32_t b01 = p2.x - p1.x;
-    int32_t a12 = p2.y - p3.y;
-    int32_t b12 = p3.x - p2.x;
-    int32_t a20 = p3.y - p1.y;
-    int32_t b20 = p1.x - p3.x;
-
+    // a pixel is covered when all three edge functions are >= 0, each edge
+    // function changes by `a` per pixel along a row and by `b` per row
     Point tl(triangle_bounds.x, triangle_bounds.y);
-    int32_t w0row = orient2d(p2, p3, tl) + bias0;
-    int32_t w1row = orient2d(p3, p1, tl) + bias1;
-    int32_t w2row = orient2d(p1, p2, tl) + bias2;
+    int32_t a[3] = {p2.y - p3.y, p3.y - p1.y, p1.y - p2.y};
+    int32_t b[3] = {p3.x - p2.x, p1.x - p3.x, p2.x - p1.x};
+    int32_t w[3] = {
+      orient2d(p2, p3, tl) + bias0,
+      orient2d(p3, p1, tl) + bias1,
+      orient2d(p1, p2, tl) + bias2
+    };
+
+    // each edge bounds the span on one side of the row, convert it to a
+    // stepper for the first (a > 0) or last (a < 0) covered pixel offset
+    //   a > 0: x >= ceil(-w / a)  = floor((a - 1 - w) / a)
+    //   a < 0: x <= floor(w / -a)
+    // horizontal edges (a == 0) either cover a whole row or none of it
+    EdgeStepper left[3], right[3];
+    int left_count = 0, right_count = 0;
+    for(auto i = 0; i < 3; i++) {
+      if(a[i] > 0) left[left_count++]   = EdgeStepper(a[i] - 1 - w[i], a[i], -b[i]);
+      if(a[i] < 0) right[right_count++] = EdgeStepper(w[i], -a[i], b[i]);
+    }
 
+    Point dest(triangle_bounds.x, triangle_bounds.y);
     for (int32_t y = 0; y < triangle_bounds.h; y++) {
-      int32_t w0 = w0row;
-      int32_t w1 = w1row;
-      int32_t w2 = w2row;
-
-      Point dest = Point(triangle_bounds.x, triangle_bounds.y + y);
-      for (int32_t x = 0; x < triangle_bounds.w; x++) {
-        if ((w0 | w1 | w2) >= 0) {
-          set_pixel(dest);
-        }
-
-        dest.x++;
+      int32_t x1 = 0, x2 = triangle_bounds.w - 1;
+      for(auto i = 0; i < left_count; i++)  x1 = std::max(x1, left[i].q);
+      for(auto i = 0; i < right_count; i++) x2 = std::min(x2, right[i].q);
+      for(auto i = 0; i < 3; i++) {
+        if(a[i] == 0 && w[i] < 0) x2 = -1;
+      }
 
-        w0 += a12;
-        w1 += a20;
-        w2 += a01;
+      if(x1 <= x2) {
+        set_pixel_span(Point(dest.x + x1, dest.y), x2 - x1 + 1);
       }
 
-      w0row += b12;
-      w1row += b20;
-      w2row += b01;
+      for(auto i = 0; i < left_count; i++)  left[i].next();
+      for(auto i = 0; i < right_count; i++) right[i].next();
+      for(auto i = 0; i < 3; i++) w[i] += b[i];
+      dest.y++;
     }
   }
 
+  // An edge of a polygon in the edge table, x is stepped down the edge one
+  // scanline at a time while it is in the active edge list
+  struct PolygonEdge {
+    int32_t y_start;   // first scanline the edge crosses
+    int32_t y_end;     // last scanline the edge crosses
+    int32_t x_top;     // x at the upper end of the edge
+    EdgeStepper step;  // offset from x_top for the current scanline
+
+    int32_t x() const {return x_top + step.q;}
+  };
+
+  // polygons with up to this many edges are filled without allocating
+  constexpr size_t POLYGON_STATIC_EDGES = 32;
+
   void PicoGraphics::polygon(const std::vector<Point> &points) {
-    static int32_t nodes[64]; // maximum allowed number of nodes per scanline for polygon rendering
+    polygon(points.data(), points.size());
+  }
 
-    int32_t miny = points[0].y, maxy = points[0].y;
+  void PicoGraphics::polygon(const Point *points, size_t count) {
+    if(count < 3) return;
+
+    if(display_list) {record_points(DisplayList::POLYGON, points, count); return;}
+
+    PolygonEdge static_edges[POLYGON_STATIC_EDGES];
+    PolygonEdge *static_active[POLYGON_STATIC_EDGES];
+    std::vector<PolygonEdge> dynamic_edges;
+    std::vector<PolygonEdge *> dynamic_active;
+    PolygonEdge *edges = static_edges;
+    PolygonEdge **active = static_active;
+    if(count > POLYGON_STATIC_EDGES) {
+      dynamic_edges.resize(count);
+      dynamic_active.resize(count);
+      edges = dynamic_edges.data();
+      active = dynamic_active.data();
+    }
 
-    for (uint16_t i = 1; i < points.size(); i++) {
+    // only fill scanlines inside both the polygon and the clip rectangle
+    int32_t minx = points[0].x, maxx = points[0].x;
+    int32_t miny = points[0].y, maxy = points[0].y;
+    for(size_t i = 1; i < count; i++) {
+      minx = std::min(minx, points[i].x);
+      maxx = std::max(maxx, points[i].x);
       miny = std::min(miny, points[i].y);
       maxy = std::max(maxy, points[i].y);
     }
+    int32_t first_y = std::max(clip.y, miny);
+    int32_t last_y = std::min(clip.y + clip.h - 1, maxy);
+    if(first_y > last_y) return;
+
+    // damage the whole polygon up front, each span is then already covered
+    add_damage(Rect(Point(minx, first_y), Point(maxx + 1, last_y + 1)).intersection(clip));
+
+    // build the edge table, an edge crosses scanlines (top, bottom] so that
+    // shared vertices are only counted once and horizontal edges are skipped
+    size_t edge_count = 0;
+    for(size_t i = 0; i < count; i++) {
+      Point top = points[i];
+      Point bottom = points[(i + 1) % count];
+      if(top.y == bottom.y) continue;
+      if(top.y > bottom.y) std::swap(top, bottom);
+      if(bottom.y < first_y || top.y >= last_y) continue;
+
+      PolygonEdge &edge = edges[edge_count++];
+      edge.y_start = std::max(top.y + 1, first_y);
+      edge.y_end = bottom.y;
+      edge.x_top = top.x;
+      int32_t dx = bottom.x - top.x, dy = bottom.y - top.y;
+      edge.step = EdgeStepper((edge.y_start - top.y) * dx, dy, dx);
+    }
 
-    // for each scanline within the polygon bounds (clipped to clip rect)
-    Point p;
-
-    for (p.y = std::max(clip.y, miny); p.y <= std::min(clip.y + clip.h, maxy); p.y++) {
-      uint8_t n = 0;
-      for (uint16_t i = 0; i < points.size(); i++) {
-        uint16_t j = (i + 1) % points.size();
-        int32_t sy = points[i].y;
-        int32_t ey = points[j].y;
-        int32_t fy = p.y;
-        if ((sy < fy && ey >= fy) || (ey < fy && sy >= fy)) {
-          int32_t sx = points[i].x;
-          int32_t ex = points[j].x;
-          int32_t px = int32_t(sx + float(fy - sy) / float(ey - sy) * float(ex - sx));
+    std::sort(edges, edges + edge_count, [](const PolygonEdge &a, const PolygonEdge &b) {
+      return a.y_start < b.y_start;
+    });
+
+    size_t next_edge = 0;
+    size_t active_count = 0;
+    for(int32_t y = first_y; y <= last_y; y++) {
+      // retire edges that ended above this scanline, step the rest
+      size_t kept = 0;
+      for(size_t i = 0; i < active_count; i++) {
+        if(active[i]->y_end < y) continue;
+        active[i]->step.next();
+        active[kept++] = active[i];
+      }
+      active_count = kept;
 
-          nodes[n++] = px < clip.x ? clip.x : (px >= clip.x + clip.w ? clip.x + clip.w - 1 : px);// clamp(int32_t(sx + float(fy - sy) / float(ey - sy) * float(ex - sx)), clip.x, clip.x + clip.w);
-        }
+      // add edges that start on this scanline
+      while(next_edge < edge_count && edges[next_edge].y_start == y) {
+        active[active_count++] = &edges[next_edge++];
       }
 
-      uint16_t i = 0;
-      while (i < n - 1) {
-        if (nodes[i] > nodes[i + 1]) {
-          int32_t s = nodes[i]; nodes[i] = nodes[i + 1]; nodes[i + 1] = s;
-          if (i) i--;
-        }
-        else {
-          i++;
+      // keep the active list in x order, it is almost sorted already from the
+      // previous scanline so an insertion sort does very little work
+      for(size_t i = 1; i < active_count; i++) {
+        PolygonEdge *e = active[i];
+        int32_t x = e->x();
+        size_t j = i;
+        while(j > 0 && active[j - 1]->x() > x) {
+          active[j] = active[j - 1];
+          j--;
         }
+        active[j] = e;
       }
 
-      for (uint16_t i = 0; i < n; i += 2) {
-        pixel_span(Point(nodes[i], p.y), nodes[i + 1] - nodes[i] + 1);
+      // fill between pairs of crossings
+      for(size_t i = 0; i + 1 < active_count; i += 2) {
+        int32_t x1 = active[i]->x();
+        int32_t x2 = active[i + 1]->x();
+        pixel_span(Point(x1, y), x2 - x1 + 1);
       }
     }
   }
 
   void PicoGraphics::thick_line(Point p1, Point p2, uint thickness) {
+    thick_line(p1, p2, thickness, line_cap);
+  }
+
+  void PicoGraphics::thick_line(Point p1, Point p2, uint thickness, LineCap cap) {
+    if(display_list) {
+      int32_t t = thickness;
+      auto c = record_command(DisplayList::THICK_LINE, std::min(p1.y, p2.y) - t, std::max(p1.y, p2.y) + t, p1.x, p1.y, p2.x, p2.y);
+      if(c) {
+        c->thickness = thickness;
+        c->cap = cap;
+      }
+      return;
+    }
+
     int32_t ht = thickness / 2;
     int32_t t = (int32_t)thickness;
 
-    // fast horizontal line
-    if(p1.y == p2.y) {
-      int32_t start = std::min(p1.x, p2.x);
-      int32_t end   = std::max(p1.x, p2.x);
-      rectangle(Rect(start, p1.y - ht, end - start, t));
-      return;
+    // the footprint thick_line has always had: butt ends on horizontal and
+    // vertical lines, otherwise a t×t square at every step along the major
+    // axis but the last, with the minor axis stepped in 16.16 fixed point
+    if(cap == CAP_AUTO) {
+      if(p1.x == p2.x || p1.y == p2.y) {
+        cap = CAP_BUTT;
+      } else {
+        if(t == 0) return;
+
+        int32_t dx = p2.x - p1.x, dy = p2.y - p1.y;
+        bool shallow = std::abs(dx) > std::abs(dy);
+        int32_t steps = shallow ? std::abs(dx) : std::abs(dy);
+        int64_t sx = shallow ? (dx < 0 ? -65536 : 65536) : int64_t(dx) * 65536 / steps;
+        int64_t sy = shallow ? int64_t(dy) * 65536 / steps : (dy < 0 ? -65536 : 65536);
+
+        // top left of the kth square counting down the rows, neighbouring
+        // squares are at most a pixel apart so each row is one span, from
+        // the first square covering it to the last
+        auto square = [&](int32_t k) {
+          int64_t i = dy < 0 ? steps - 1 - k : k;
+          return Point(
+            int32_t((int64_t(p1.x) * 65536 + i * sx) >> 16) - ht,
+            int32_t((int64_t(p1.y) * 65536 + i * sy) >> 16) - ht);
+        };
+
+        Point first = square(0), last = square(steps - 1);
+        Rect stamps = Rect(
+          Point(std::min(first.x, last.x), first.y),
+          Point(std::max(first.x, last.x) + t, last.y + t)).intersection(clip);
+        if(stamps.empty()) return;
+        add_damage(stamps);
+
+        int32_t a = 0, b = 0;
+        for(auto y = stamps.y; y < stamps.y + stamps.h; y++) {
+          while(b + 1 < steps && square(b + 1).y <= y) b++;
+          while(square(a).y + t <= y) a++;
+          int32_t xa = square(a).x, xb = square(b).x;
+          int32_t x1 = std::max(std::min(xa, xb), stamps.x);
+          int32_t x2 = std::min(std::max(xa, xb) + t, stamps.x + stamps.w);
+          if(x2 > x1) set_pixel_span(Point(x1, y), x2 - x1);
+        }
+        return;
+      }
     }
 
-    // fast vertical line
-    if(p1.x == p2.x) {
-      int32_t start  = std::min(p1.y, p2.y);
-      int32_t length = std::max(p1.y, p2.y) - start;
-      rectangle(Rect(p1.x - ht, start, t, length));
-      return;
+    if(cap == CAP_BUTT) {
+      // fast horizontal line
+      if(p1.y == p2.y) {
+        int32_t start = std::min(p1.x, p2.x);
+        int32_t end   = std::max(p1.x, p2.x);
+        rectangle(Rect(start, p1.y - ht, end - start, t));
+        return;
+      }
+
+      // fast vertical line
+      if(p1.x == p2.x) {
+        int32_t start  = std::min(p1.y, p2.y);
+        int32_t length = std::max(p1.y, p2.y) - start;
+        rectangle(Rect(p1.x - ht, start, t, length));
+        return;
+      }
+    }
+
+    // the stroke is the band of pixels within half the thickness of the line
+    // (the strip) limited to the length of the line, optionally extended by
+    // half the thickness (square) or joined by a disc at each end (round).
+    // it is convex so every row is a single span, bounded by where the row
+    // crosses the strip, the length limits and the discs. the geometry is
+    // set up in float and then stepped from row to row in 16.16 fixed point
+    float dx = p2.x - p1.x;
+    float dy = p2.y - p1.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    float half = thickness * 0.5f;
+
+    if(length == 0.0f) {
+      // a dot, only caps have anything to draw
+      if(cap == CAP_BUTT) return;
+      dx = 1.0f; length = 1.0f;
     }
 
-    // general purpose line
-    // lines are either "shallow" or "steep" based on whether the x delta
-    // is greater than the y delta
-    int32_t dx = p2.x - p1.x;
-    int32_t dy = p2.y - p1.y;
-    bool shallow = std::abs(dx) > std::abs(dy);
-    if(shallow) {
-      // shallow version
-      int32_t s = std::abs(dx);       // number of steps
-      int32_t sx = dx < 0 ? -1 : 1;   // x step value
-      int32_t sy = (dy << 16) / s;    // y step value in fixed 16:16
-      int32_t x = p1.x;
-      int32_t y = p1.y << 16;
-      while(s--) {
-        rectangle({x - ht, (y >> 16) - ht, t, t});
-        y += sy;
-        x += sx;
+    // unit direction, the normal is (-uy, ux)
+    float inv_length = 1.0f / length;
+    float ux = dx * inv_length, uy = dy * inv_length;
+
+    // pixels are sampled at their centres, when the thickness is even the
+    // stroke sits half a pixel up and left of the line to match rectangle()
+    // and the axis-aligned fast paths
+    float ox = p1.x, oy = p1.y;
+    float ex = p2.x, ey = p2.y;
+    if((thickness & 1) == 0) {ox -= 0.5f; oy -= 0.5f; ex -= 0.5f; ey -= 0.5f;}
+
+    // distance along the line covered by the flat part of the stroke
+    float start = 0.0f, end = p1 == p2 ? 0.0f : length;
+    if(cap == CAP_SQUARE) {start -= half; end += half;}
+
+    auto ceil_int = [](float v) {
+      int32_t i = int32_t(v);
+      return float(i) < v ? i + 1 : i;
+    };
+
+    // rows covered by the flat part and by the whole stroke
+    float extent = std::abs(uy) * (end - start) * 0.5f + std::abs(ux) * half;
+    float mid = oy + uy * (start + end) * 0.5f;
+    int32_t flat_y1 = ceil_int(mid - extent);
+    int32_t flat_y2 = ceil_int(mid + extent);
+    int32_t y1 = flat_y1, y2 = flat_y2;
+    if(cap == CAP_ROUND) {
+      y1 = std::min(y1, ceil_int(std::min(oy, ey) - half));
+      y2 = std::max(y2, ceil_int(std::max(oy, ey) + half));
+    }
+    y1 = std::max(y1, clip.y);
+    y2 = std::min(y2, clip.y + clip.h);
+    if(y1 >= y2) return;
+
+    // no part of the stroke is further than the thickness from the line
+    add_damage(Rect(
+      Point(std::min(p1.x, p2.x) - t, y1),
+      Point(std::max(p1.x, p2.x) + t + 1, y2)).intersection(clip));
+
+    auto fixed = [](float v) {return int64_t(v * 65536.0f);};
+    const int64_t unbounded = int64_t(1) << 48;
+
+    // a band `lo <= k.(p - o) <= hi` crosses row y1 between x = lo and x = hi
+    // and both move by `step` on each following row
+    struct Band {int64_t lo, hi, step;};
+    auto band = [&](float kx, float ky, float lo, float hi) {
+      if(kx == 0.0f) {
+        // parallel to the rows, the row range above already limits it
+        return Band{-unbounded, unbounded, 0};
+      }
+      if(kx < 0.0f) std::swap(lo, hi);
+      float inv = 1.0f / kx;
+      float d = ky * (float(y1) - oy);
+      return Band{fixed(ox + (lo - d) * inv), fixed(ox + (hi - d) * inv), fixed(-ky * inv)};
+    };
+
+    Band strip = band(-uy, ux, -half, half);
+    Band along = band(ux, uy, start, end);
+    // half widths of the end discs by row distance from their centre, both
+    // discs sit at the same sub-pixel offset so they share the table
+    const int32_t DISC_TABLE = 32;
+    int64_t disc[DISC_TABLE];
+    int32_t disc_rows = 0;
+    float r2 = half * half;
+    float f = (thickness & 1) ? 0.0f : 0.5f;
+    if(cap == CAP_ROUND) {
+      for(; disc_rows < DISC_TABLE; disc_rows++) {
+        float d = disc_rows + f;
+        if(d * d >= r2) break;
+        disc[disc_rows] = fixed(sqrtf(r2 - d * d));
+      }
+    }
+
+    auto disc_width = [&](int32_t k) {
+      // k is the row offset from the end point, -1 if outside the disc
+      int32_t j = f == 0.0f ? std::abs(k) : (k >= 0 ? k : -k - 1);
+      if(j < DISC_TABLE) return j < disc_rows ? disc[j] : int64_t(-1);
+      float d = j + f;
+      return d * d < r2 ? fixed(sqrtf(r2 - d * d)) : int64_t(-1);
+    };
+
+    int64_t fox = fixed(ox), fex = fixed(ex);
+
+    for(int32_t y = y1; y < y2; y++) {
+      int64_t l = unbounded, r = -unbounded;
+
+      if(y >= flat_y1 && y < flat_y2) {
+        l = std::max(strip.lo, along.lo);
+        r = std::min(strip.hi, along.hi);
       }
-    }else{
-      // steep version
-      int32_t s = std::abs(dy);       // number of steps
-      int32_t sy = dy < 0 ? -1 : 1;   // y step value
-      int32_t sx = (dx << 16) / s;    // x step value in fixed 16:16
-      int32_t y = p1.y;
-      int32_t x = p1.x << 16;
-      while(s--) {
-        rectangle({(x >> 16) - ht, y - ht, t, t});
-        y += sy;
-        x += sx;
+      strip.lo += strip.step; strip.hi += strip.step;
+      along.lo += along.step; along.hi += along.step;
+
+      if(cap == CAP_ROUND) {
+        // the discs overlap the flat part so the row is still one span
+        int64_t w = disc_width(y - p1.y);
+        if(w >= 0) {l = std::min(l, fox - w); r = std::max(r, fox + w);}
+        w = disc_width(y - p2.y);
+        if(w >= 0) {l = std::min(l, fex - w); r = std::max(r, fex + w);}
       }
+
+      // cover the pixel centres in [l, r)
+      int32_t x1 = int32_t(std::max((l + 0xffff) >> 16, int64_t(clip.x)));
+      int32_t x2 = int32_t(std::min((r + 0xffff) >> 16, int64_t(clip.x + clip.w)));
+      if(x2 > x1) set_pixel_span(Point(x1, y), x2 - x1);
     }
   }
 
@@ -351,111 +772,170 @@ namespace pimoroni {
       return;
     }
 
-    // fast vertical line
-    if(p1.x == p2.x) {
-      int32_t start  = std::min(p1.y, p2.y);
-      int32_t length = std::max(p1.y, p2.y) - start;
-      Point dest(p1.x, start);
-      while(length--) {
-        pixel(dest);
-        dest.y++;
-      }
+    if(display_list) {record_command(DisplayList::LINE, std::min(p1.y, p2.y), std::max(p1.y, p2.y), p1.x, p1.y, p2.x, p2.y); return;}
+
+    add_damage(Rect(
+      Point(std::min(p1.x, p2.x), std::min(p1.y, p2.y)),
+      Point(std::max(p1.x, p2.x) + 1, std::max(p1.y, p2.y) + 1)).intersection(clip));
+    set_pixel_line(p1, p2);
+  }
+
+  // bounding box of `count` points, as pixels
+  static Rect bounding_rect(const Point *points, size_t count) {
+    Point lo = points[0], hi = points[0];
+    for(auto i = 1u; i < count; i++) {
+      lo.x = std::min(lo.x, points[i].x); hi.x = std::max(hi.x, points[i].x);
+      lo.y = std::min(lo.y, points[i].y); hi.y = std::max(hi.y, points[i].y);
+    }
+    return Rect(lo, Point(hi.x + 1, hi.y + 1));
+  }
+
+  // The batched primitives below draw the same pixels as calling pixel(),
+  // line(), rectangle() or circle() for each item, but clip and mark damage
+  // once for the batch. A DisplayList records them one at a time.
+
+  void PicoGraphics::points(const Point *points, size_t count) {
+    if(!count) return;
+    if(display_list) {
+      for(auto i = 0u; i < count; i++) pixel(points[i]);
       return;
     }
 
+    Rect box = bounding_rect(points, count);
+    Rect clipped = box.intersection(clip);
+    if(clipped.empty()) return;
 
-    // general purpose line
-    // lines are either "shallow" or "steep" based on whether the x delta
-    // is greater than the y delta
-    int32_t dx = p2.x - p1.x;
-    int32_t dy = p2.y - p1.y;
-    bool shallow = std::abs(dx) > std::abs(dy);
-    if(shallow) {
-      // shallow version
-      int32_t s = std::abs(dx);       // number of steps
-      int32_t sx = dx < 0 ? -1 : 1;   // x step value
-      int32_t sy = (dy << 16) / s;    // y step value in fixed 16:16
-      int32_t x = p1.x;
-      int32_t y = p1.y << 16;
-      while(s--) {
-        Point p(x, y >> 16);
-        pixel(p);
-        y += sy;
-        x += sx;
-      }
-    }else{
-      // steep version
-      int32_t s = std::abs(dy);       // number of steps
-      int32_t sy = dy < 0 ? -1 : 1;   // y step value
-      int32_t sx = (dx << 16) / s;    // x step value in fixed 16:16
-      int32_t y = p1.y;
-      int32_t x = p1.x << 16;
-      while(s--) {
-        Point p(x >> 16, y);
-        pixel(p);
-        y += sy;
-        x += sx;
+    add_damage(clipped);
+    set_pixel_points(points, count, clip.contains(box));
+  }
+
+  // Joins each of `points` to the next with line()
+  void PicoGraphics::lines(const Point *points, size_t count) {
+    if(count < 2) return;
+    if(display_list) {
+      for(auto i = 1u; i < count; i++) line(points[i - 1], points[i]);
+      return;
+    }
+
+    Rect clipped = bounding_rect(points, count).intersection(clip);
+    if(clipped.empty()) return;
+    add_damage(clipped);
+
+    for(auto i = 1u; i < count; i++) {
+      const Point &p1 = points[i - 1], &p2 = points[i];
+      if(p1.y != p2.y) {
+        set_pixel_line(p1, p2);
+        continue;
       }
+
+      // horizontal lines stop short of their end, as line() draws them
+      if(p1.y < clip.y || p1.y >= clip.y + clip.h) continue;
+      int32_t x1 = std::max(std::min(p1.x, p2.x), clip.x);
+      int32_t x2 = std::min(std::max(p1.x, p2.x), clip.x + clip.w);
+      if(x2 > x1) set_pixel_span(Point(x1, p1.y), x2 - x1);
+    }
+  }
+
+  void PicoGraphics::rectangles(const Rect *rects, size_t count) {
+    if(display_list) {
+      for(auto i = 0u; i < count; i++) rectangle(rects[i]);
+      return;
     }
+
+    Rect damaged;
+    for(auto i = 0u; i < count; i++) {
+      Rect clipped = rects[i].intersection(clip);
+      if(clipped.empty()) continue;
+
+      set_pixel_rect(clipped);
+      damaged = damaged.empty() ? clipped : bounding_rect(damaged, clipped);
+    }
+    if(!damaged.empty()) add_damage(damaged);
   }
 
-  // Common function for frame buffer conversion to 565 pixel format
-  void PicoGraphics::frame_convert_rgb565(conversion_callback_func callback, next_pixel_func get_next_pixel)
-  {
-    // Allocate two temporary buffers, as the callback may transfer by DMA
-    // while we're preparing the next part of the row
-    const int BUF_LEN = 64;
-    uint16_t row_buf[2][BUF_LEN];
-    int buf_idx = 0;
-    int buf_entry = 0;
-    for(auto i = 0; i < bounds.w * bounds.h; i++) {
-      row_buf[buf_idx][buf_entry] = get_next_pixel();
-      buf_entry++;
-
-      // Transfer a filled buffer and swap to the next one
-      if (buf_entry == BUF_LEN) {
-          callback(row_buf[buf_idx], BUF_LEN * sizeof(RGB565));
-          buf_idx ^= 1;
-          buf_entry = 0;
+  // Draws a circle of radius `r` about each of `centres`. The width of each
+  // row is worked out once for the batch, larger circles than that has room
+  // for are drawn by circle()
+  void PicoGraphics::circles(const Point *centres, size_t count, int32_t r) {
+    const int32_t MAX_RADIUS = 64;
+    if(!count || r < 0) return;
+    if(display_list || r > MAX_RADIUS) {
+      for(auto i = 0u; i < count; i++) circle(centres[i], r);
+      return;
+    }
+
+    // half the width of the rows `dy` above and below the centre, stepped
+    // out as circle() does
+    int32_t half[MAX_RADIUS + 1] = {0};
+    int ox = r, oy = 0, err = -r;
+    while(ox >= oy) {
+      int last_oy = oy;
+      err += oy; oy++; err += oy;
+      half[last_oy] = std::max(half[last_oy], ox);
+      if(err >= 0 && ox != last_oy) {
+        half[ox] = std::max(half[ox], last_oy);
+        err -= ox; ox--; err -= ox;
       }
     }
 
-    // Transfer any remaining pixels ( < BUF_LEN )
-    if(buf_entry > 0) {
-        callback(row_buf[buf_idx], buf_entry * sizeof(RGB565));
+    Rect damaged;
+    for(auto i = 0u; i < count; i++) {
+      const Point &p = centres[i];
+      if(!Rect(p.x - r, p.y - r, r * 2, r * 2).intersects(clip)) continue;
+
+      Rect box = Rect(p.x - r, p.y - r, r * 2 + 1, r * 2 + 1).intersection(clip);
+      if(box.empty()) continue;
+      damaged = damaged.empty() ? box : bounding_rect(damaged, box);
+
+      for(auto y = box.y; y < box.y + box.h; y++) {
+        int32_t w = half[std::abs(y - p.y)];
+        int32_t x1 = std::max(p.x - w, box.x);
+        int32_t x2 = std::min(p.x + w + 1, box.x + box.w);
+        if(x2 > x1) set_pixel_span(Point(x1, y), x2 - x1);
+      }
     }
+    if(!damaged.empty()) add_damage(damaged);
+  }
 
-    // Callback with zero length to ensure previous buffer is fully written
-    callback(row_buf[buf_idx], 0);
+  void PicoGraphics::set_pixel_points(const Point *points, size_t count, bool inside) {
+    for(auto i = 0u; i < count; i++) {
+      if(inside || clip.contains(points[i])) set_pixel(points[i]);
+    }
   }
 
-  // Common function for frame buffer conversion to 565 pixel format
-  void PicoGraphics::frame_convert_rgb888(conversion_callback_func callback, next_pixel_func_rgb888 get_next_pixel)
-  {
-    // Allocate two temporary buffers, as the callback may transfer by DMA
-    // while we're preparing the next part of the row
-    const int BUF_LEN = 64;
-    RGB888 row_buf[2][BUF_LEN];
-    int buf_idx = 0;
-    int buf_entry = 0;
-    for(auto i = 0; i < bounds.w * bounds.h; i++) {
-      row_buf[buf_idx][buf_entry] = get_next_pixel();
-      buf_entry++;
+  void PicoGraphics::set_pixel_glyph(const Point &p, const uint32_t *columns, uint width, uint scale) {
+    uint32_t rows[32] = {0};
+    uint32_t used = 0;
+    for(auto cx = 0u; cx < width; cx++) {
+      uint32_t data = columns[cx];
+      used |= data;
+      while(data) {
+        rows[__builtin_ctz(data)] |= 1u << cx;
+        data &= data - 1;
+      }
+    }
 
-      // Transfer a filled buffer and swap to the next one
-      if (buf_entry == BUF_LEN) {
-          callback(row_buf[buf_idx], BUF_LEN * sizeof(RGB888));
-          buf_idx ^= 1;
-          buf_entry = 0;
+    Point row = p;
+    for(auto cy = 0u; used; cy++, used >>= 1) {
+      for(auto i = 0u; i < scale; i++, row.y++) {
+        if(rows[cy]) set_pixel_mask(row, rows[cy], scale);
       }
     }
+  }
 
-    // Transfer any remaining pixels ( < BUF_LEN )
-    if(buf_entry > 0) {
-        callback(row_buf[buf_idx], buf_entry * sizeof(RGB888));
+  void PicoGraphics::set_pixel_mask(const Point &p, uint32_t mask, uint scale) {
+    while(mask) {
+      uint first = __builtin_ctz(mask);
+      uint rest = ~(mask >> first);
+      uint run = rest ? __builtin_ctz(rest) : 32 - first;
+      mask = first + run < 32 ? mask & (~0U << (first + run)) : 0;
+      set_pixel_span(Point(p.x + first * scale, p.y), run * scale);
     }
+  }
 
-    // Callback with zero length to ensure previous buffer is fully written
-    callback(row_buf[buf_idx], 0);
+  void PicoGraphics::set_pixel_line(const Point &p1, const Point &p2) {
+    rasterize_line(p1, p2, clip, [this](int32_t x, int32_t y) {
+      set_pixel(Point(x, y));
+    });
   }
 }
@@ -17,6 +17,8 @@
 
 #include "common/pimoroni_common.hpp"
 
+#include "pico_graphics_formats.hpp"
+
 // A tiny graphics library for our Pico products
 // supports:
 //   - 16-bit (565) RGB
@@ -138,7 +140,34 @@ namespace pimoroni {
     }
   };
 
-
+  // Finds the closest palette entry to a colour, giving the same answer as
+  // RGB::closest without measuring the distance to every entry.
+  //
+  // The colour cube is split into 8x8x8 cells. The first lookup in a cell
+  // gathers the entries that could be closest to anything inside it: those
+  // whose nearest possible distance is within the smallest furthest possible
+  // distance of any entry. Later lookups in the cell measure only those,
+  // which for a well spread palette is a handful. Changing the palette drops
+  // every cell and they're rebuilt one at a time as colours land in them.
+  class PaletteIndex {
+    public:
+      void invalidate();
+      int closest(const RGB &c, const RGB *palette, size_t len);
+
+    private:
+      static const uint CELLS = 512;
+      // cells with more candidates than this compare every entry
+      static const uint MAX_CANDIDATES = 48;
+
+      const RGB *palette = nullptr;
+      size_t len = 0;
+      uint32_t built[CELLS / 32] = {0};
+      uint16_t offset[CELLS];
+      uint8_t count[CELLS];
+      std::vector<uint8_t> candidates;
+
+      void build_cell(uint cell);
+  };
 
   typedef int Pen;
 
@@ -181,6 +210,40 @@ namespace pimoroni {
     void deflate(int32_t v);
   };
 
+  // A 2D affine transform, mapping (x, y) to (a * x + b * y + tx,
+  // c * x + d * y + ty). Transforms combine right to left, so
+  // translation(p) * rotation(r) rotates and then moves.
+  struct Affine {
+    float a = 1.0f, b = 0.0f, c = 0.0f, d = 1.0f, tx = 0.0f, ty = 0.0f;
+
+    static Affine translation(float x, float y) {return {1.0f, 0.0f, 0.0f, 1.0f, x, y};}
+    static Affine scale(float x, float y) {return {x, 0.0f, 0.0f, y, 0.0f, 0.0f};}
+    // clockwise on the display, as y runs down
+    static Affine rotation(float degrees) {
+      float r = degrees * float(M_PI) / 180.0f, s = sinf(r), c = cosf(r);
+      return {c, -s, s, c, 0.0f, 0.0f};
+    }
+    static Affine skew(float x_degrees, float y_degrees) {
+      return {1.0f, tanf(x_degrees * float(M_PI) / 180.0f), tanf(y_degrees * float(M_PI) / 180.0f), 1.0f, 0.0f, 0.0f};
+    }
+
+    Affine operator* (const Affine &m) const {
+      return {
+        a * m.a + b * m.c, a * m.b + b * m.d,
+        c * m.a + d * m.c, c * m.b + d * m.d,
+        a * m.tx + b * m.ty + tx, c * m.tx + d * m.ty + ty
+      };
+    }
+
+    // the transform back again, singular ones give all zeros
+    Affine inverse() const {
+      float det = a * d - b * c;
+      if(det == 0.0f) return {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+      float i = 1.0f / det;
+      return {d * i, -b * i, -c * i, a * i, (b * ty - d * tx) * i, (c * tx - a * ty) * i};
+    }
+  };
+
   static const RGB565 rgb332_to_rgb565_lut[256] = {
     0x0000, 0x0800, 0x1000, 0x1800, 0x0001, 0x0801, 0x1001, 0x1801, 0x0002, 0x0802, 0x1002, 0x1802, 0x0003, 0x0803, 0x1003, 0x1803,
     0x0004, 0x0804, 0x1004, 0x1804, 0x0005, 0x0805, 0x1005, 0x1805, 0x0006, 0x0806, 0x1006, 0x1806, 0x0007, 0x0807, 0x1007, 0x1807,
@@ -202,6 +265,432 @@ namespace pimoroni {
 
   extern const uint8_t dither16_pattern[16];
 
+  // Ordered dither candidates for the palette pens (see set_pixel_dither).
+  //
+  // Colours are grouped into 512 cells by the top three bits of red, green
+  // and blue, each cell keeping the 16 palette entries its 4x4 pattern picks
+  // from. Nothing is allocated until the first dithered pixel and each cell
+  // is only worked out the first time it's drawn. Palettes of up to 16
+  // colours keep two entries to a byte.
+  //
+  // A cache remembers the colours it was built for, so pens with the same
+  // palette can share one (see PicoGraphics::set_dither_cache).
+  class DitherCache {
+    public:
+      // a number standing for a palette's contents, pens take a new one
+      // whenever their palette changes
+      static uint32_t new_version();
+
+      // ready the cache for `palette`, keeping the cells already worked out
+      // if its colours are the ones they were built for. `expand` stretches
+      // each cell's colour to the full 0-255 range rather than its lowest
+      // corner, and `index` speeds up searching large palettes.
+      inline void use(const RGB *palette, size_t len, uint32_t version, bool expand, PaletteIndex *index = nullptr) {
+        if(version != this->version || len != this->len) adopt(palette, len, version, expand, index);
+      }
+
+      // the palette entry for `c` at `pattern_index` of the 4x4 pattern
+      inline uint8_t get(const RGB &c, uint pattern_index) {
+        uint key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
+        if(!(built[key >> 5] & (1u << (key & 31)))) build(key);
+
+        uint i = dither16_pattern[pattern_index];
+        if(packed) return (cells[key * 8 + (i >> 1)] >> ((i & 1) << 2)) & 0xf;
+        return cells[key * 16 + i];
+      }
+
+      // free the cells, they're worked out again as they're drawn
+      void reset();
+
+    private:
+      static const uint CELLS = 512;
+
+      const RGB *palette = nullptr;   // of the pen drawing
+      PaletteIndex *index = nullptr;
+      size_t len = 0;
+      uint32_t version = 0;
+      bool expand = false;
+      bool packed = false;
+      uint32_t built[CELLS / 32] = {0};
+      std::vector<RGB> colours;       // the palette the cells were built for
+      std::vector<uint8_t> cells;
+
+      void adopt(const RGB *palette, size_t len, uint32_t version, bool expand, PaletteIndex *index);
+      void build(uint key);
+  };
+
+  // Walks the pixels of a one pixel wide line from p1 towards p2 (excluding
+  // p2) and calls `plot(x, y)` for each one that lies inside `clip`. Shared
+  // by PicoGraphics::line() and the per-format specializations, which pass a
+  // plot that writes straight into the frame buffer.
+  template<typename Plot>
+  inline void rasterize_line(Point p1, Point p2, const Rect &clip, Plot &&plot) {
+    const int32_t cx1 = clip.x, cx2 = clip.x + clip.w;
+    const int32_t cy1 = clip.y, cy2 = clip.y + clip.h;
+
+    // fast vertical line, clipped once up front
+    if(p1.x == p2.x) {
+      if(p1.x < cx1 || p1.x >= cx2) return;
+      int32_t start = std::max(std::min(p1.y, p2.y), cy1);
+      int32_t end   = std::min(std::max(p1.y, p2.y), cy2);
+      for(int32_t y = start; y < end; y++) {
+        plot(p1.x, y);
+      }
+      return;
+    }
+
+    // general purpose line
+    // lines are either "shallow" or "steep" based on whether the x delta
+    // is greater than the y delta
+    int32_t dx = p2.x - p1.x;
+    int32_t dy = p2.y - p1.y;
+    bool shallow = std::abs(dx) > std::abs(dy);
+    if(shallow) {
+      // shallow version
+      int32_t s = std::abs(dx);       // number of steps
+      int32_t sx = dx < 0 ? -1 : 1;   // x step value
+      int32_t sy = (dy << 16) / s;    // y step value in fixed 16:16
+      int32_t x = p1.x;
+      int32_t y = p1.y << 16;
+      while(s--) {
+        int32_t py = y >> 16;
+        if(x >= cx1 && x < cx2 && py >= cy1 && py < cy2) plot(x, py);
+        y += sy;
+        x += sx;
+      }
+    }else{
+      // steep version
+      int32_t s = std::abs(dy);       // number of steps
+      int32_t sy = dy < 0 ? -1 : 1;   // y step value
+      int32_t sx = (dx << 16) / s;    // x step value in fixed 16:16
+      int32_t y = p1.y;
+      int32_t x = p1.x << 16;
+      while(s--) {
+        int32_t px = x >> 16;
+        if(px >= cx1 && px < cx2 && y >= cy1 && y < cy2) plot(px, y);
+        y += sy;
+        x += sx;
+      }
+    }
+  }
+
+  // Drawing recorded by PicoGraphics::record(), to be replayed by
+  // PicoGraphics::render() a strip of rows at a time so that the frame buffer
+  // only needs to hold a few rows of the display rather than all of it.
+  //
+  // Each command keeps the pen it was drawn with and the rows it can touch,
+  // a strip only replays the commands that reach it. Anything of variable
+  // size lives in the tables alongside and the command holds its index.
+  class PicoGraphics;
+
+  class DisplayList {
+    public:
+      enum Op : uint8_t {
+        CLIP,
+        PIXEL,
+        PIXEL_SPAN,
+        RECTANGLE,
+        CIRCLE,
+        TRIANGLE,
+        POLYGON,
+        LINE,
+        THICK_LINE,
+        CHARACTER,
+        TEXT,
+        SPRITE,
+        BLIT,
+      };
+
+      struct Command {
+        Op op;
+        uint8_t cap;        // THICK_LINE, CHARACTER and TEXT only
+        uint16_t thickness; // THICK_LINE only
+        int16_t y1, y2;     // first and last row the command can draw to
+        uint32_t pen;
+        int32_t args[4];    // coordinates, or an index into a table
+      };
+
+      struct Text {
+        const bitmap::font_t *bitmap_font;
+        const hershey::font_t *hershey_font;
+        uint thickness;
+        int32_t wrap;
+        float s;
+        float a;
+        uint8_t letter_spacing;
+        bool fixed_width;
+        uint32_t offset;    // into chars
+        uint32_t length;
+      };
+
+      struct Sprite {
+        void *data;
+        Point sprite;
+        int scale;
+        int transparent;
+      };
+
+      struct Blit {
+        PicoGraphics *src;
+        Rect src_rect;
+        int scale;
+        int transparent;
+      };
+
+      std::vector<Command> commands;
+      std::vector<Point> points;   // TRIANGLE and POLYGON vertices
+      std::vector<Text> texts;     // TEXT and CHARACTER
+      std::vector<char> chars;
+      std::vector<Sprite> sprites;
+      std::vector<Blit> blits;
+
+      void clear();
+  };
+
+  // State for error diffusion dithering (see PicoGraphics::set_error_diffusion)
+  // of images drawn to a palette pen.
+  //
+  // Each frame buffer column keeps the error owed to the next row it will
+  // draw and the two after it (Atkinson reaches two rows down), in 1/16ths
+  // of a channel level, so memory is proportional to the width of the
+  // display. Rows only need to reach each column in order, so images
+  // decoded in blocks (JPEG) can be diffused a block at a time. Error a
+  // block passes on to the next block's first columns, which are still
+  // rows behind, is kept aside until they catch up. Error passed back into
+  // the previous block's last column is lost, as those rows are already
+  // drawn, so drawing in blocks isn't quite the same as a row at a time.
+  class ErrorDiffusion {
+    public:
+      enum Kernel : uint8_t {
+        FLOYD_STEINBERG,
+        ATKINSON,
+      };
+
+      struct Column {
+        int16_t row;          // the next row this column will draw
+        bool owed;            // has error kept aside in `owed`
+        int16_t error[3][3];  // r, g, b for that row and the two below
+      };
+
+      // error for a row further below a column than it keeps
+      struct Owed {
+        int16_t x, y;
+        int16_t error[3];
+      };
+
+      // how far below a column error is kept aside for, a JPEG block and
+      // the kernel's reach
+      static const int32_t MAX_OWED_ROWS = 18;
+
+      Kernel kernel;
+      bool serpentine;        // odd rows drawn by set_pixels_dither() run right to left
+      std::vector<Column> columns;
+      std::vector<Owed> owed;
+
+      ErrorDiffusion(Kernel kernel = FLOYD_STEINBERG, bool serpentine = true)
+       : kernel(kernel), serpentine(serpentine) {}
+
+      // forget any error carried over from what was last drawn
+      void reset() {columns.clear(); owed.clear();}
+  };
+
+  // A string shaped by PicoGraphics::layout_text() in the font it was given,
+  // ready for PicoGraphics::text() to draw as often as needed.
+  //
+  // Positions are from the origin text is drawn at, before any rotation,
+  // with glyphs in the order they are drawn and each line pointing at its
+  // own. Laying out the same string, font and options again keeps these, so
+  // one layout can be kept per label and passed every frame.
+  class TextLayout {
+    public:
+      enum Align : uint8_t {
+        LEFT,
+        CENTER,
+        RIGHT,
+        JUSTIFY,  // wrapped lines are stretched to the wrap width
+      };
+
+      struct Glyph {
+        int16_t x, y;
+        char c;
+        unicode_sorta::codepage_t codepage;
+      };
+
+      struct Line {
+        uint16_t first, count;  // its glyphs
+        int16_t x, y;           // left of the first glyph and top of the line
+        int16_t width;          // left of the first glyph to the right of the last
+      };
+
+      std::vector<Glyph> glyphs;
+      std::vector<Line> lines;
+      int32_t width = 0;        // widest line
+      int32_t height = 0;       // line pitch times the number of lines
+
+      // what it was laid out from, to tell when it needs doing again
+      std::string text;
+      const bitmap::font_t *bitmap_font = nullptr;
+      const hershey::font_t *hershey_font = nullptr;
+      int32_t wrap = 0;
+      float s = 0.0f;
+      uint8_t letter_spacing = 0;
+      bool fixed_width = false;
+      Align align = LEFT;
+
+      // the next layout_text() shapes it again
+      void reset() {bitmap_font = nullptr; hershey_font = nullptr;}
+  };
+
+  // Layers that PicoGraphics::compose() draws on top of each other, bottom
+  // first. Each is a PicoGraphics of its own, of any size and pen type, and
+  // its damage says what was drawn to it so only the rows of the display
+  // that changed are composed again.
+  //
+  // Layers at the bottom marked `cached` are a background that rarely
+  // changes. Given a PicoGraphics the display's size and pen type to keep
+  // it in they're flattened into that, and changed rows of the display are
+  // copied from it before the layers above are drawn again. The lowest layer
+  // drawn is always opaque, and should cover the display.
+  class LayerStack {
+    public:
+      struct Layer {
+        PicoGraphics *graphics;
+        Point offset;           // where its top left sits on the display
+        int transparent;        // pen that shows what's below, -1 for none
+        uint8_t alpha;          // 255 for opaque
+        bool visible;
+        bool cached;            // part of the background
+      };
+
+      // the columns of a row that need composing, none when x1 >= x2
+      struct Span {
+        int16_t x1, x2;
+      };
+
+      std::vector<Layer> layers;
+      PicoGraphics *background;
+      Rect bounds;
+      std::vector<Span> dirty;
+      std::vector<Span> background_dirty;
+
+      LayerStack(uint16_t width, uint16_t height, PicoGraphics *background = nullptr);
+
+      uint add(PicoGraphics *graphics, const Point &offset = Point(0, 0), int transparent = -1, uint8_t alpha = 255, bool cached = false);
+      void move(uint layer, const Point &offset);
+      void set_visible(uint layer, bool visible);
+      void set_alpha(uint layer, uint8_t alpha);
+
+      // compose `r` again (or everything), eg. after changing a layer's palette
+      void invalidate(const Rect &r);
+      void invalidate();
+
+      // notes that `r` of the display, and of the background if `cached`,
+      // needs composing
+      void mark(const Rect &r, bool cached);
+
+      // the layers flattened into the background
+      size_t cached_count() const;
+  };
+
+  // A map of tiles from `tiles`, a PicoGraphics holding the tile sheet with
+  // tiles numbered left to right and then down, for PicoGraphics::tilemap()
+  // to draw. Tiles can be any pen type, RGB332 or a palette (P4, P8), but
+  // opaque ones the same pen type as the display copy straight across a
+  // tile's width of a row at a time, so it's worth converting a sheet to
+  // match with blit() once up front.
+  //
+  // `scroll` is the pixel of the map drawn at the top left, so scrolling is
+  // a pixel at a time. Maps drawn one after another with transparency are
+  // layers, each with its own scroll.
+  class TileMap {
+    public:
+      PicoGraphics *tiles;
+      uint8_t tile_size;        // width and height of a tile, eg. 8 or 16
+      const uint8_t *map;       // tile numbers, a row at a time
+      uint16_t width, height;   // in tiles
+      Point scroll;
+      int transparent = -1;     // pen of `tiles` that shows what's below
+      int empty = -1;           // tile number that isn't drawn
+      bool repeat = true;       // the map wraps around rather than ending
+
+      TileMap(PicoGraphics *tiles, uint8_t tile_size, const uint8_t *map, uint16_t width, uint16_t height)
+       : tiles(tiles), tile_size(tile_size), map(map), width(width), height(height) {}
+  };
+
+  // Up to `max_sprites` sprites from a sheet laid out as PicoGraphics::sprite()
+  // takes it (RGB332, 128 pixels wide in 8x8 cells), for
+  // PicoGraphics::sprites() to draw.
+  //
+  // Whenever a sprite has changed they're sorted by priority and bucketed by
+  // the rows they cover, so drawing a row only visits the sprites on it and
+  // each writes its pixels in runs. Higher priorities are drawn over lower,
+  // equal ones in the order they were added.
+  class SpriteEngine {
+    public:
+      enum Flip : uint8_t {
+        FLIP_NONE = 0,
+        FLIP_X    = 1,
+        FLIP_Y    = 2,
+      };
+
+      struct Sprite {
+        Point position;
+        Point cell;               // column and row of the sheet's cells
+        uint8_t scale = 1;
+        uint8_t flip = FLIP_NONE;
+        uint8_t priority = 0;
+        int16_t transparent = -1; // sheet colour left undrawn, -1 for none
+        bool visible = true;
+      };
+
+      const uint8_t *sheet;
+
+      SpriteEngine(const uint8_t *sheet, uint16_t max_sprites, uint16_t height);
+
+      // the index of the new sprite, or -1 if there are already max_sprites
+      int add(const Sprite &sprite);
+      void set(uint i, const Sprite &sprite);
+      void move(uint i, const Point &position);
+      void set_visible(uint i, bool visible);
+      void clear();
+
+      const Sprite &get(uint i) const {return sprite_list[i];}
+      uint count() const {return sprite_list.size();}
+
+      // re-sorts and re-buckets the sprites if any have changed
+      void update();
+
+      // the sprites covering row `y` bottom first, as of the last update()
+      const uint16_t *row(int32_t y, uint &count) const {
+        if(y < 0 || y >= int32_t(row_start.size()) - 1) {count = 0; return nullptr;}
+        count = row_start[y + 1] - row_start[y];
+        return row_sprites.data() + row_start[y];
+      }
+
+      // sheet colours as pens of `graphics`, worked out as they're first
+      // used. invalidate_pens() forgets them, eg. after a palette change
+      void use_pens(PicoGraphics *graphics);
+      uint32_t pen(uint8_t c) {
+        if(!(pens_built[c >> 5] & (1u << (c & 31)))) build_pen(c);
+        return pens[c];
+      }
+      void invalidate_pens();
+
+    private:
+      uint16_t max_sprites;
+      std::vector<Sprite> sprite_list;
+      bool changed = true;
+
+      std::vector<uint32_t> row_start;    // per row, and one past the last
+      std::vector<uint16_t> row_sprites;
+
+      PicoGraphics *pens_for = nullptr;
+      uint32_t pens[256];
+      uint32_t pens_built[8] = {0};
+
+      void build_pen(uint8_t c);
+  };
+
   class PicoGraphics {
   public:
     enum PenType {
@@ -219,14 +708,43 @@ namespace pimoroni {
       PEN_DV_RGB888,
     };
 
+    // how thick_line finishes the ends of a stroke
+    enum LineCap {
+      CAP_BUTT,   // flat, ends exactly at the end points
+      CAP_SQUARE, // flat, extended by half the thickness
+      CAP_ROUND,  // semicircle centred on each end point
+      CAP_AUTO,   // the stepped squares thick_line has always drawn
+    };
+
     void *frame_buffer;
 
     PenType pen_type;
     Rect bounds;
     Rect clip;
     uint thickness = 1;
+    LineCap line_cap = CAP_AUTO;
+
+    // areas drawn to since the last clear_damage(), overlapping and nearby
+    // areas are merged so that there are never more than MAX_DAMAGE
+    static const uint MAX_DAMAGE = 8;
+    Rect damage[MAX_DAMAGE];
+    uint damage_count = 0;
+
+    // when set drawing is recorded here rather than to the frame buffer
+    DisplayList *display_list = nullptr;
+
+    // when set set_pixels_dither() diffuses error rather than using a pattern
+    ErrorDiffusion *error_diffusion = nullptr;
+
+    // when set palette pens dither with this rather than their own cache
+    DitherCache *dither_cache = nullptr;
+
+    // optional caller supplied storage for frame_convert (see set_convert_buffer)
+    void *convert_buffer = nullptr;
+    size_t convert_buffer_size = 0;
 
     typedef std::function<void(void *data, size_t length)> conversion_callback_func;
+    typedef std::function<void(int32_t y)> strip_callback_func;
     typedef std::function<RGB565()> next_pixel_func;
     typedef std::function<RGB888()> next_pixel_func_rgb888;
     //typedef std::function<void(int y)> scanline_interrupt_func;
@@ -236,6 +754,9 @@ namespace pimoroni {
     const bitmap::font_t *bitmap_font;
     const hershey::font_t *hershey_font;
 
+    // hershey glyphs as drawn recently, so repeated text skips transforming them
+    hershey::GlyphCache glyph_cache;
+
     static constexpr RGB332 rgb_to_rgb332(uint8_t r, uint8_t g, uint8_t b) {
       return RGB(r, g, b).to_rgb332();
     }
@@ -274,12 +795,21 @@ namespace pimoroni {
 
     virtual void set_pen(uint c) = 0;
     virtual void set_pen(uint8_t r, uint8_t g, uint8_t b) = 0;
+    virtual uint get_pen();
+    virtual RGB pen_to_rgb(uint pen);
+    virtual uint rgb_to_pen(const RGB &c);
+    virtual const void *pixel_layout();
     virtual void set_pixel(const Point &p) = 0;
     virtual void set_pixel_span(const Point &p, uint l) = 0;
+    virtual void set_pixel_rect(const Rect &r);
     void set_thickness(uint t);
+    void set_line_cap(LineCap cap);
+    void set_convert_buffer(void *buffer, size_t length);
 
     virtual int get_palette_size();
     virtual RGB* get_palette();
+    // the palette entry closest to `c`, or -1 for pens without a palette
+    virtual int closest_pen(const RGB &c);
     virtual bool supports_alpha_blend();
 
     virtual int create_pen(uint8_t r, uint8_t g, uint8_t b);
@@ -289,8 +819,12 @@ namespace pimoroni {
     virtual void set_pixel_dither(const Point &p, const RGB &c);
     virtual void set_pixel_dither(const Point &p, const RGB565 &c);
     virtual void set_pixel_dither(const Point &p, const uint8_t &c);
+    void set_pixels_dither(const Point &p, uint l, const RGB *c);
+    void set_pixels_dither(const Point &p, uint l, const RGB565 *c);
+    void set_pixel_diffused(const Point &p, const RGB &c, bool reverse = false);
     virtual void set_pixel_alpha(const Point &p, const uint8_t a);
     virtual void frame_convert(PenType type, conversion_callback_func callback);
+    virtual void frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback);
     virtual void sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent);
 
     virtual bool render_pico_vector_tile(const Rect &bounds, uint8_t* alpha_data, uint32_t stride, uint8_t alpha_type) { return false; }
@@ -308,6 +842,15 @@ namespace pimoroni {
     void set_clip(const Rect &r);
     void remove_clip();
 
+    void add_damage(const Rect &r);
+    void clear_damage();
+
+    void set_error_diffusion(ErrorDiffusion *diffusion);
+    void set_dither_cache(DitherCache *cache);
+
+    void record(DisplayList *list);
+    void render(const DisplayList &list, int32_t strip_height, strip_callback_func callback);
+
     void clear();
     void pixel(const Point &p);
     void pixel_span(const Point &p, int32_t l);
@@ -316,42 +859,258 @@ namespace pimoroni {
     void character(const char c, const Point &p, float s = 2.0f, float a = 0.0f);
     void text(const std::string_view &t, const Point &p, int32_t wrap, float s = 2.0f, float a = 0.0f, uint8_t letter_spacing = 1, bool fixed_width = false);
     int32_t measure_text(const std::string_view &t, float s = 2.0f, uint8_t letter_spacing = 1, bool fixed_width = false);
+    bool layout_text(TextLayout &layout, const std::string_view &t, int32_t wrap, float s = 2.0f, uint8_t letter_spacing = 1, bool fixed_width = false, TextLayout::Align align = TextLayout::LEFT);
+    void text(const TextLayout &layout, const Point &p, float a = 0.0f);
+    void blit(PicoGraphics *src, const Rect &src_rect, const Point &dest, int scale = 1, int transparent = -1);
+    void blit(PicoGraphics *src, const Rect &src_rect, const Affine &transform, int transparent = -1, bool bilinear = false, uint8_t alpha = 255);
+    void compose(LayerStack &stack);
+    void sprites(SpriteEngine &engine, int32_t y = 0);
+    void tilemap(const TileMap &map, int32_t y = 0);
     void polygon(const std::vector<Point> &points);
+    void polygon(const Point *points, size_t count);
     void triangle(Point p1, Point p2, Point p3);
     void line(Point p1, Point p2);
     void thick_line(Point p1, Point p2, uint thickness);
+    void thick_line(Point p1, Point p2, uint thickness, LineCap cap);
+    void points(const Point *points, size_t count);
+    void lines(const Point *points, size_t count);
+    void rectangles(const Rect *rects, size_t count);
+    void circles(const Point *centres, size_t count, int32_t r);
 
   protected:
-    void frame_convert_rgb565(conversion_callback_func callback, next_pixel_func get_next_pixel);
-    void frame_convert_rgb888(conversion_callback_func callback, next_pixel_func_rgb888 get_next_pixel);
+    // draws `count` single pixels, skipping those outside the clip unless
+    // they're all `inside` it. Overridden by PicoGraphicsT to plot directly
+    virtual void set_pixel_points(const Point *points, size_t count, bool inside);
+
+    // draws a one pixel wide line that is not horizontal, overridden by
+    // PicoGraphicsT to plot without a virtual call per pixel
+    virtual void set_pixel_line(const Point &p1, const Point &p2);
+
+    // draws each set bit of `mask` (bit 0 leftmost) as `scale` pixels along
+    // the row from `p`, overridden by PicoGraphicsT to fill each run directly
+    virtual void set_pixel_mask(const Point &p, uint32_t mask, uint scale);
+
+    // draws the glyph `columns` (see bitmap::glyph) with the top left of
+    // their canvas at `p`, each pixel `scale` square and none outside the
+    // clip. The default turns them into rows for set_pixel_mask()
+    virtual void set_pixel_glyph(const Point &p, const uint32_t *columns, uint width, uint scale);
+
+    void bitmap_character(const char c, const Point &p, uint8_t scale, int32_t rotation, unicode_sorta::codepage_t codepage);
+
+    // pixels as raw pen values for blit(), the defaults plot through
+    // set_pixel() and can't read anything back
+    virtual void get_pens(const Point &p, uint l, uint32_t *pens);
+    // `l` pixels from 16.16 fixed point (`u`, `v`) stepping by (`du`, `dv`),
+    // each clamped to `within`
+    virtual void sample_pens(const Rect &within, int32_t u, int32_t v, int32_t du, int32_t dv, uint l, uint32_t *pens);
+    virtual void set_pens(const Point &p, uint l, const uint32_t *pens);
+    // copies `l` pixels from `src` without conversion if it has the same
+    // frame buffer layout, returns false if it hasn't
+    virtual bool copy_pixels(PicoGraphics *src, const Point &s, const Point &d, uint l);
+    // draws layers `first` up to `last` of `stack` where they cover `r`,
+    // the first of them opaque if `opaque_first`
+    void compose_layers(const LayerStack &stack, size_t first, size_t last, const Rect &r, bool opaque_first);
+
+    DisplayList::Command *record_command(DisplayList::Op op, int32_t y1, int32_t y2, int32_t a = 0, int32_t b = 0, int32_t c = 0, int32_t d = 0);
+    void record_points(DisplayList::Op op, const Point *points, size_t count);
+    void record_text(DisplayList::Op op, const std::string_view &t, const Point &p, int32_t wrap, float s, float a, uint8_t letter_spacing, bool fixed_width);
+    void record_sprite(void *data, const Point &sprite, const Point &dest, int scale, int transparent);
+    void record_blit(PicoGraphics *src, const Rect &src_rect, const Point &dest, int scale, int transparent);
+
+    // Converts `region` (in units of output, pixels or bytes for 4-bit
+    // output, of a buffer `stride` units wide) in chunks, calling
+    // `convert(offset, count, dst)` to fill each chunk and passing it to
+    // `callback`. Rows are packed back to back, as a display expects within
+    // its address window. Chunks alternate between the two halves of the
+    // buffer, as the callback may transfer one by DMA while we're preparing
+    // the next, and a final zero length callback signals the end.
+    template<typename T, typename Convert>
+    void frame_convert_chunks(conversion_callback_func callback, const Rect &region, size_t stride, Convert &&convert) {
+      const size_t DEFAULT_CHUNK = 64;
+      alignas(4) T default_buf[2][DEFAULT_CHUNK];
+
+      T *buf[2] = {default_buf[0], default_buf[1]};
+      size_t chunk = DEFAULT_CHUNK;
+      if(convert_buffer) {
+        // a multiple of four units keeps both halves word aligned and packed
+        // sources starting on a byte boundary
+        chunk = (convert_buffer_size / 2 / sizeof(T)) & ~size_t(0b11);
+        if(chunk) {
+          buf[0] = (T *)convert_buffer;
+          buf[1] = (T *)((uint8_t *)convert_buffer + chunk * sizeof(T));
+        } else {
+          chunk = DEFAULT_CHUNK;
+        }
+      }
+
+      // whole rows are one contiguous run
+      size_t rows = region.h, width = region.w;
+      if(region.x == 0 && size_t(region.w) == stride) {
+        width *= rows;
+        rows = 1;
+      }
+
+      int buf_idx = 0;
+      size_t used = 0;
+      for(size_t row = 0; row < rows; row++) {
+        size_t offset = (region.y + row) * stride + region.x;
+        size_t remaining = width;
+        while(remaining) {
+          size_t count = std::min(chunk - used, remaining);
+          convert(offset, count, buf[buf_idx] + used);
+          offset += count;
+          remaining -= count;
+          used += count;
+
+          // Transfer a filled buffer and swap to the next one
+          if(used == chunk) {
+            callback(buf[buf_idx], chunk * sizeof(T));
+            buf_idx ^= 1;
+            used = 0;
+          }
+        }
+      }
+
+      // Transfer any remaining units ( < chunk )
+      if(used) {
+        callback(buf[buf_idx], used * sizeof(T));
+        buf_idx ^= 1;
+      }
+
+      // Callback with zero length to ensure previous buffer is fully written
+      callback(buf[buf_idx], 0);
+    }
+
+    template<typename T, typename Convert>
+    void frame_convert_chunks(conversion_callback_func callback, size_t total, Convert &&convert) {
+      frame_convert_chunks<T>(callback, Rect(0, 0, total, 1), total, convert);
+    }
   };
 
-  class PicoGraphics_Pen1Bit : public PicoGraphics {
+  // Rendering core specialized for a frame buffer pixel format (see
+  // pico_graphics_formats.hpp). Pixels, spans, rectangles and lines are
+  // written by inlined Format code rather than a virtual call per pixel, the
+  // PicoGraphics_Pen* classes derived from it only add colour handling.
+  template<typename Format>
+  class PicoGraphicsT : public PicoGraphics {
+    public:
+      typename Format::color_t color;
+
+      PicoGraphicsT(uint16_t width, uint16_t height, void *frame_buffer)
+      : PicoGraphics(width, height, frame_buffer) {}
+
+      uint get_pen() override {
+        return color;
+      }
+
+      // identifies the frame buffer layout, the same for every pen using Format
+      const void *pixel_layout() override {
+        static const char id = 0;
+        return &id;
+      }
+
+      void set_pixel(const Point &p) override {
+        Format::plot(frame_buffer, bounds.w, bounds.h, p.x, p.y, color);
+      }
+
+      void set_pixel_span(const Point &p, uint l) override {
+        Format::span(frame_buffer, bounds.w, bounds.h, p.x, p.y, l, color);
+      }
+
+      void set_pixel_rect(const Rect &r) override {
+        for(auto y = r.y; y < r.y + r.h; y++) {
+          Format::span(frame_buffer, bounds.w, bounds.h, r.x, y, r.w, color);
+        }
+      }
+
+    protected:
+      void set_pixel_mask(const Point &p, uint32_t mask, uint scale) override {
+        while(mask) {
+          uint first = __builtin_ctz(mask);
+          uint rest = ~(mask >> first);
+          uint run = rest ? __builtin_ctz(rest) : 32 - first;
+          mask = first + run < 32 ? mask & (~0U << (first + run)) : 0;
+          Format::span(frame_buffer, bounds.w, bounds.h, p.x + first * scale, p.y, run * scale, color);
+        }
+      }
+
+      void get_pens(const Point &p, uint l, uint32_t *pens) override {
+        for(auto i = 0u; i < l; i++) {
+          pens[i] = Format::get(frame_buffer, bounds.w, bounds.h, p.x + i, p.y);
+        }
+      }
+
+      void sample_pens(const Rect &within, int32_t u, int32_t v, int32_t du, int32_t dv, uint l, uint32_t *pens) override {
+        int32_t x2 = within.x + within.w - 1, y2 = within.y + within.h - 1;
+        for(auto i = 0u; i < l; i++, u += du, v += dv) {
+          int32_t x = std::clamp(u >> 16, within.x, x2), y = std::clamp(v >> 16, within.y, y2);
+          pens[i] = Format::get(frame_buffer, bounds.w, bounds.h, x, y);
+        }
+      }
+
+      void set_pens(const Point &p, uint l, const uint32_t *pens) override {
+        for(auto i = 0u; i < l; i++) {
+          Format::plot(frame_buffer, bounds.w, bounds.h, p.x + i, p.y, (typename Format::color_t)pens[i]);
+        }
+      }
+
+      bool copy_pixels(PicoGraphics *src, const Point &s, const Point &d, uint l) override {
+        if(src->pen_type != pen_type || src->pixel_layout() != pixel_layout()) return false;
+        Format::copy(frame_buffer, bounds.w, bounds.h, d.x, d.y, src->frame_buffer, src->bounds.w, src->bounds.h, s.x, s.y, l);
+        return true;
+      }
+
+      void set_pixel_points(const Point *points, size_t count, bool inside) override {
+        if(inside) {
+          for(auto i = 0u; i < count; i++) {
+            Format::plot(frame_buffer, bounds.w, bounds.h, points[i].x, points[i].y, color);
+          }
+          return;
+        }
+        for(auto i = 0u; i < count; i++) {
+          if(clip.contains(points[i])) Format::plot(frame_buffer, bounds.w, bounds.h, points[i].x, points[i].y, color);
+        }
+      }
+
+      void set_pixel_line(const Point &p1, const Point &p2) override {
+        void *buf = frame_buffer;
+        int32_t w = bounds.w, h = bounds.h;
+        typename Format::color_t c = color;
+        rasterize_line(p1, p2, clip, [buf, w, h, c](int32_t x, int32_t y) {
+          Format::plot(buf, w, h, x, y, c);
+        });
+      }
+  };
+
+  class PicoGraphics_Pen1Bit : public PicoGraphicsT<formats::Format1Bit> {
     public:
-      uint8_t color;
-    
       PicoGraphics_Pen1Bit(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
-
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
 
       static size_t buffer_size(uint w, uint h) {
           return w * h / 8;
       }
   };
 
-  class PicoGraphics_Pen1BitY : public PicoGraphics {
+  class PicoGraphics_Pen1BitY : public PicoGraphicsT<formats::Format1BitY> {
     public:
-      uint8_t color;
-    
       PicoGraphics_Pen1BitY(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
 
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
+      void set_pixel_rect(const Rect &r) override;
+
+      uint8_t column_pattern(int x);
+
+    protected:
+      void set_pixel_glyph(const Point &p, const uint32_t *columns, uint width, uint scale) override;
+
+    public:
 
       static size_t buffer_size(uint w, uint h) {
           return w * h / 8;
@@ -383,14 +1142,17 @@ namespace pimoroni {
         {220, 180, 200}  // clean / taupe?!
       };
 
-      std::array<std::array<uint8_t, 16>, 512> candidate_cache;
-      bool cache_built = false;
-      std::array<uint8_t, 16> candidates;
+      DitherCache candidate_cache;
+      uint32_t palette_version;
 
       PicoGraphics_Pen3Bit(uint16_t width, uint16_t height, void *frame_buffer);
 
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      uint get_pen() override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
+      void get_pens(const Point &p, uint l, uint32_t *pens) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
 
@@ -400,7 +1162,6 @@ namespace pimoroni {
       void _set_pixel(const Point &p, uint col);
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
-      void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
       void set_pixel_dither(const Point &p, const RGB &c) override;
 
       void frame_convert(PenType type, conversion_callback_func callback) override;
@@ -409,20 +1170,20 @@ namespace pimoroni {
       }
   };
 
-  class PicoGraphics_PenP4 : public PicoGraphics {
+  class PicoGraphics_PenP4 : public PicoGraphicsT<formats::FormatP4> {
     public:
       static const uint16_t palette_size = 16;
-      uint8_t color;
       RGB palette[palette_size];
       bool used[palette_size];
 
-      std::array<std::array<uint8_t, 16>, 512> candidate_cache;
-      bool cache_built = false;
-      std::array<uint8_t, 16> candidates;
+      DitherCache candidate_cache;
+      uint32_t palette_version;
 
       PicoGraphics_PenP4(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int update_pen(uint8_t i, uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
@@ -431,31 +1192,29 @@ namespace pimoroni {
       int get_palette_size() override {return palette_size;};
       RGB* get_palette() override {return palette;};
 
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
-      void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
       void set_pixel_dither(const Point &p, const RGB &c) override;
 
-      void frame_convert(PenType type, conversion_callback_func callback) override;
+      void frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) override;
       static size_t buffer_size(uint w, uint h) {
           return w * h / 2;
       }
   };
 
-  class PicoGraphics_PenP8 : public PicoGraphics {
+  class PicoGraphics_PenP8 : public PicoGraphicsT<formats::Format8Bit> {
     public:
       static const uint16_t palette_size = 256;
-      uint8_t color;
       RGB palette[palette_size];
       bool used[palette_size];
     
-      std::array<std::array<uint8_t, 16>, 512> candidate_cache;
-      bool cache_built = false;
-      std::array<uint8_t, 16> candidates;
+      DitherCache candidate_cache;
+      uint32_t palette_version;
+      PaletteIndex palette_index;
 
       PicoGraphics_PenP8(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int update_pen(uint8_t i, uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
@@ -463,28 +1222,25 @@ namespace pimoroni {
 
       int get_palette_size() override {return palette_size;};
       RGB* get_palette() override {return palette;};
+      int closest_pen(const RGB &c) override;
 
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
-      void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
       void set_pixel_dither(const Point &p, const RGB &c) override;
 
-      void frame_convert(PenType type, conversion_callback_func callback) override;
+      void frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h;
       }
   };
 
-  class PicoGraphics_PenRGB332 : public PicoGraphics {
+  class PicoGraphics_PenRGB332 : public PicoGraphicsT<formats::Format8Bit> {
     public:
-      RGB332 color;
       PicoGraphics_PenRGB332(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
       void set_pixel_dither(const Point &p, const RGB &c) override;
       void set_pixel_dither(const Point &p, const RGB565 &c) override;
       void set_pixel_alpha(const Point &p, const uint8_t a) override;
@@ -493,39 +1249,48 @@ namespace pimoroni {
 
       void sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent) override;
 
-      void frame_convert(PenType type, conversion_callback_func callback) override;
+      void frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h;
       }
   };
 
-  class PicoGraphics_PenRGB565 : public PicoGraphics {
+  class PicoGraphics_PenRGB565 : public PicoGraphicsT<formats::FormatRGB565> {
     public:
       RGB src_color;
-      RGB565 color;
       PicoGraphics_PenRGB565(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
+      void set_pixel_alpha(const Point &p, const uint8_t a) override;
+
+      bool supports_alpha_blend() override {return true;}
+      bool render_pico_vector_tile(const Rect &bounds, uint8_t* alpha_data, uint32_t stride, uint8_t alpha_type) override;
+
       static size_t buffer_size(uint w, uint h) {
         return w * h * sizeof(RGB565);
       }
   };
 
-  class PicoGraphics_PenRGB888 : public PicoGraphics {
+  class PicoGraphics_PenRGB888 : public PicoGraphicsT<formats::FormatRGB888> {
     public:
       RGB src_color;
-      RGB888 color;
       PicoGraphics_PenRGB888(uint16_t width, uint16_t height, void *frame_buffer);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
-      void set_pixel(const Point &p) override;
-      void set_pixel_span(const Point &p, uint l) override;
+      void set_pixel_alpha(const Point &p, const uint8_t a) override;
+
+      bool supports_alpha_blend() override {return true;}
+      bool render_pico_vector_tile(const Rect &bounds, uint8_t* alpha_data, uint32_t stride, uint8_t alpha_type) override;
+
+      void frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h * sizeof(uint32_t);
       }
@@ -543,6 +1308,20 @@ namespace pimoroni {
 
       virtual void update(PicoGraphics *display) {};
       virtual void partial_update(PicoGraphics *display, Rect region) {};
+      // send the frame buffer, a strip rendered from a DisplayList, to the
+      // display starting at row `y`
+      virtual void update_strip(PicoGraphics *display, int32_t y) {};
+      // send only what has been drawn since the last update, drivers that
+      // can't address part of the display send the whole frame
+      virtual void update_damaged(PicoGraphics *display) {
+        update(display);
+        display->clear_damage();
+      };
+      // start sending the frame buffer and return, the frame buffer must not
+      // be drawn to until wait_idle() returns or is_busy() is false. Drivers
+      // that can't transfer in the background send it before returning
+      virtual void present_async(PicoGraphics *display) {update(display);};
+      virtual void wait_idle() {};
       virtual bool set_update_speed(int update_speed) {return false;};
       virtual void set_backlight(uint8_t brightness) {};
       virtual bool is_busy() {return false;};
@@ -550,11 +1329,43 @@ namespace pimoroni {
       virtual void cleanup() {};
   };
 
+  // Flips a PicoGraphics between two frame buffers so the next frame can be
+  // drawn while the last one is still being sent to the display.
+  //
+  // Only the display's own transfer is waited on, so the buffer handed back
+  // for drawing holds the frame before last and needs redrawing in full.
+  class SwapChain {
+    public:
+      PicoGraphics &graphics;
+      DisplayDriver &display;
+      void *buffers[2];
+      uint drawing = 0;
+
+      SwapChain(PicoGraphics &graphics, DisplayDriver &display, void *buffer_a, void *buffer_b)
+      : graphics(graphics), display(display), buffers{buffer_a, buffer_b} {
+        graphics.set_framebuffer(buffers[drawing]);
+      };
+
+      void present() {
+        // the other buffer may still be going out from the last present
+        display.wait_idle();
+        display.present_async(&graphics);
+        drawing ^= 1;
+        graphics.set_framebuffer(buffers[drawing]);
+      };
+  };
+
   template<typename T> class IDirectDisplayDriver {
      public:
        virtual void write_pixel(const Point &p, T colour) = 0;
        virtual void write_pixel_span(const Point &p, uint l, T colour) = 0;
 
+       // `l` pixels of differing colours, drivers that can send a row in one
+       // go should
+       virtual void write_pixels(const Point &p, uint l, const T *data) {
+         for(auto i = 0u; i < l; i++) write_pixel(Point(p.x + i, p.y), data[i]);
+       }
+
        virtual void read_pixel(const Point &p, T &data) {};
        virtual void read_pixel_span(const Point &p, uint l, T *data) {};
    };
@@ -590,9 +1401,8 @@ namespace pimoroni {
         {220, 180, 200}  // clean / taupe?!
       };
 
-      std::array<std::array<uint8_t, 16>, 512> candidate_cache;
-      bool cache_built = false;
-      std::array<uint8_t, 16> candidates;
+      DitherCache candidate_cache;
+      uint32_t palette_version;
     
       uint color;
       IDirectDisplayDriver<uint8_t> &driver;
@@ -600,6 +1410,9 @@ namespace pimoroni {
       PicoGraphics_PenInky7(uint16_t width, uint16_t height, IDirectDisplayDriver<uint8_t> &direct_display_driver);
       void set_pen(uint c) override;
       void set_pen(uint8_t r, uint8_t g, uint8_t b) override;
+      uint get_pen() override;
+      RGB pen_to_rgb(uint pen) override;
+      uint rgb_to_pen(const RGB &c) override;
       int create_pen(uint8_t r, uint8_t g, uint8_t b) override;
       int create_pen_hsv(float h, float s, float v) override;
       void set_pixel(const Point &p) override;
@@ -608,7 +1421,6 @@ namespace pimoroni {
       int get_palette_size() override {return palette_size;};
       RGB* get_palette() override {return palette;};
 
-      void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
       void set_pixel_dither(const Point &p, const RGB &c) override;
 
       void frame_convert(PenType type, conversion_callback_func callback) override;
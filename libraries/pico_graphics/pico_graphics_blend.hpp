@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Alpha blending kernels for the true colour frame buffer layouts.
+//
+// Channels are blended together in a single word rather than one at a time.
+// RGB565 is spread so green sits in the upper half of the word with room
+// above each channel for a 5-bit multiply, giving 33 levels of alpha (0-32).
+// RGB888 blends red and blue together and green on its own with 8-bit alpha
+// (0-256).
+//
+// Coverage kernels take a row of antialiasing sample counts (as produced by
+// PicoVector) where `1 << shift` samples is fully covered.
+
+namespace pimoroni {
+  namespace blend {
+
+    // frame buffer RGB565 (byte swapped) to its spread form
+    static inline uint32_t spread_rgb565(uint16_t c) {
+      uint32_t p = __builtin_bswap16(c);
+      return (p | (p << 16)) & 0x07e0f81f;
+    }
+
+    static inline uint16_t pack_rgb565(uint32_t p) {
+      p &= 0x07e0f81f;
+      return __builtin_bswap16(uint16_t(p | (p >> 16)));
+    }
+
+    // `dst` moved towards the spread colour `src` by `a` out of 32, the
+    // constant rounds each channel to nearest
+    static inline uint16_t rgb565(uint16_t dst, uint32_t src, uint32_t a) {
+      uint32_t d = spread_rgb565(dst);
+      return pack_rgb565((src * a + d * (32 - a) + 0x02008010) >> 5);
+    }
+
+    // `dst` moved towards `src` by `a` out of 256
+    static inline uint32_t rgb888(uint32_t dst, uint32_t src, uint32_t a) {
+      uint32_t rb = ((src & 0xff00ff) * a + (dst & 0xff00ff) * (256 - a)) >> 8;
+      uint32_t g  = ((src & 0x00ff00) * a + (dst & 0x00ff00) * (256 - a)) >> 8;
+      return (rb & 0xff00ff) | (g & 0x00ff00);
+    }
+
+    // `count` pixels of `dst` covered by `color` as much as `coverage` says
+    static inline void coverage_rgb565(uint16_t *dst, const uint8_t *coverage, size_t count, uint16_t color, uint32_t shift) {
+      const uint32_t full = 1u << shift;
+      const uint32_t src = spread_rgb565(color);
+      for(size_t i = 0; i < count; i++) {
+        uint32_t c = coverage[i];
+        if(!c) continue;
+        if(c >= full) {
+          dst[i] = color;
+        } else {
+          dst[i] = rgb565(dst[i], src, (c << 5) >> shift);
+        }
+      }
+    }
+
+    static inline void coverage_rgb888(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t color, uint32_t shift) {
+      const uint32_t full = 1u << shift;
+      for(size_t i = 0; i < count; i++) {
+        uint32_t c = coverage[i];
+        if(!c) continue;
+        if(c >= full) {
+          dst[i] = color;
+        } else {
+          dst[i] = rgb888(dst[i], color, (c << 8) >> shift);
+        }
+      }
+    }
+
+  }
+}
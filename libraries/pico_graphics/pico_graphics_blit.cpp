@@ -0,0 +1,562 @@
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  void PicoGraphics::get_pens(const Point &p, uint l, uint32_t *pens) {
+    while(l--) *pens++ = 0;
+  }
+
+  void PicoGraphics::sample_pens(const Rect &within, int32_t u, int32_t v, int32_t du, int32_t dv, uint l, uint32_t *pens) {
+    int32_t x2 = within.x + within.w - 1, y2 = within.y + within.h - 1;
+    for(auto i = 0u; i < l; i++, u += du, v += dv) {
+      get_pens(Point(std::clamp(u >> 16, within.x, x2), std::clamp(v >> 16, within.y, y2)), 1, &pens[i]);
+    }
+  }
+
+  void PicoGraphics::set_pens(const Point &p, uint l, const uint32_t *pens) {
+    Point lp = p;
+    while(l--) {
+      set_pen(*pens++);
+      set_pixel(lp);
+      lp.x++;
+    }
+  }
+
+  bool PicoGraphics::copy_pixels(PicoGraphics *src, const Point &s, const Point &d, uint l) {
+    return false;
+  }
+
+  // Source pens converted to ours, converting can mean a palette search so
+  // the most recent are remembered. Sources with few pens (up to 4-bit) never
+  // miss once seen.
+  class BlitPenMap {
+    static const uint SIZE = 64;
+    uint32_t keys[SIZE];
+    uint32_t pens[SIZE];
+    uint64_t filled = 0;
+    PicoGraphics *src;
+    PicoGraphics *dst;
+    bool same;
+
+  public:
+    BlitPenMap(PicoGraphics *src, PicoGraphics *dst)
+    : src(src), dst(dst), same(src->pen_type == dst->pen_type) {}
+
+    uint32_t map(uint32_t pen) {
+      if(same) return pen;
+
+      uint i = (pen ^ (pen >> 6) ^ (pen >> 12) ^ (pen >> 18)) & (SIZE - 1);
+      if(!((filled >> i) & 1) || keys[i] != pen) {
+        keys[i] = pen;
+        pens[i] = dst->rgb_to_pen(src->pen_to_rgb(pen));
+        filled |= uint64_t(1) << i;
+      }
+      return pens[i];
+    }
+  };
+
+  // Copies `src_rect` of `src` to `dest`, each pixel scaled up to a `scale`
+  // pixel square. Source pixels matching the pen `transparent` are skipped.
+  //
+  // Clipping is worked out once up front, rows are then either copied
+  // straight across (same format, unscaled and opaque) or read in chunks as
+  // pens, converted and written back. A surface may blit to itself when
+  // unscaled.
+  void PicoGraphics::blit(PicoGraphics *src, const Rect &src_rect, const Point &dest, int scale, int transparent) {
+    if(scale < 1) return;
+
+    if(display_list) {record_blit(src, src_rect, dest, scale, transparent); return;}
+
+    // clip to the source, moving the destination to match
+    Rect s = src_rect.intersection(src->bounds);
+    if(s.empty()) return;
+    Rect target(dest.x + (s.x - src_rect.x) * scale, dest.y + (s.y - src_rect.y) * scale, s.w * scale, s.h * scale);
+
+    // then to our clip
+    Rect visible = target.intersection(clip);
+    if(visible.empty()) return;
+
+    add_damage(visible);
+
+    // offset into the scaled source of the visible area
+    int32_t ox = visible.x - target.x;
+    int32_t oy = visible.y - target.y;
+
+    // work away from any overlap when copying within a surface
+    bool reverse_rows = src == this && visible.y > s.y + oy;
+    bool reverse_cols = src == this && visible.x > s.x + ox;
+
+    bool opaque = transparent < 0;
+    bool direct = scale == 1 && opaque;
+    // 1-bit pens are dithered by position, so a row can't stand in for another
+    bool repeat_rows = opaque && pen_type != PEN_1BIT;
+
+    const uint CHUNK = 32;
+    uint32_t pens[CHUNK];
+    uint32_t out[CHUNK];
+    BlitPenMap map(src, this);
+    uint pen = get_pen();
+
+    int32_t last_sy = -1, last_dy = 0;
+    for(int32_t i = 0; i < visible.h; i++) {
+      int32_t row = reverse_rows ? visible.h - 1 - i : i;
+      int32_t dy = visible.y + row;
+      int32_t sy = s.y + (oy + row) / scale;
+
+      // copy straight across, unless it's the same row of the same surface
+      // where the copy could overlap itself
+      if(direct && !(src == this && sy == dy)) {
+        if(copy_pixels(src, Point(s.x + ox, sy), Point(visible.x, dy), visible.w)) continue;
+      }
+
+      // scaled up rows repeat the last one drawn
+      if(repeat_rows && sy == last_sy) {
+        if(copy_pixels(this, Point(visible.x, last_dy), Point(visible.x, dy), visible.w)) continue;
+      }
+      last_sy = sy;
+      last_dy = dy;
+
+      for(int32_t j = 0; j < visible.w; j += CHUNK) {
+        int32_t n = std::min(int32_t(CHUNK), visible.w - j);
+        int32_t col = reverse_cols ? visible.w - j - n : j;
+
+        // the source pixels under this chunk
+        int32_t tx = ox + col;
+        int32_t sx = s.x + tx / scale;
+        int32_t fx = tx % scale;
+        src->get_pens(Point(sx, sy), (fx + n + scale - 1) / scale, pens);
+
+        // expand each source pixel `scale` times, writing runs of opaque pixels
+        int32_t k = 0, run = 0;
+        Point p(visible.x + col, dy);
+        for(int32_t x = 0; x < n; x++) {
+          if(int32_t(pens[k]) == transparent) {
+            if(run) set_pens(Point(p.x + x - run, dy), run, out + x - run);
+            run = 0;
+          } else {
+            out[x] = map.map(pens[k]);
+            run++;
+          }
+
+          if(++fx == scale) {fx = 0; k++;}
+        }
+        if(run) set_pens(Point(p.x + n - run, dy), run, out + n - run);
+      }
+    }
+
+    // the default set_pens() plots with the pen
+    set_pen(pen);
+  }
+
+  static int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+  }
+
+  // Narrows [x1, x2] to the x where `o + x * step` is within [lo, hi]
+  static void constrain_span(int64_t o, int64_t step, int64_t lo, int64_t hi, int32_t &x1, int32_t &x2) {
+    if(step == 0) {
+      if(o < lo || o > hi) x2 = x1 - 1;
+      return;
+    }
+    int64_t a = step > 0 ? lo - o : hi - o;
+    int64_t b = step > 0 ? hi - o : lo - o;
+    x1 = std::max<int64_t>(x1, -floor_div(-a, step));
+    x2 = std::min<int64_t>(x2, floor_div(b, step));
+  }
+
+  // Draws `src_rect` of `src` through `transform`, from its pixels to ours.
+  //
+  // Each of our pixels is drawn from the source pixel its centre maps back
+  // to. The rows the transformed rectangle covers, and the first and last
+  // pixel of each whose centre maps inside it, are worked out exactly in
+  // 16.16 fixed point, and the source position then steps along each row
+  // so no pixel outside is visited. Bilinear sampling mixes the four source
+  // pixels around that position, leaving out `transparent` ones, and blends
+  // by how much of the mix was opaque where we support alpha. Otherwise
+  // pixels are drawn if at least half opaque. Transformed blits aren't
+  // recorded by a DisplayList.
+  void PicoGraphics::blit(PicoGraphics *src, const Rect &src_rect, const Affine &transform, int transparent, bool bilinear, uint8_t alpha) {
+    if(display_list) return;
+
+    Rect s = src_rect.intersection(src->bounds);
+    if(s.empty() || !alpha || transform.a * transform.d == transform.b * transform.c) return;
+
+    // where the corners land bounds the rows and columns to look at
+    float min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    for(auto corner = 0; corner < 4; corner++) {
+      float cx = (corner & 1) ? s.x + s.w : s.x;
+      float cy = (corner & 2) ? s.y + s.h : s.y;
+      float x = transform.a * cx + transform.b * cy + transform.tx;
+      float y = transform.c * cx + transform.d * cy + transform.ty;
+      min_x = std::min(min_x, x); max_x = std::max(max_x, x);
+      min_y = std::min(min_y, y); max_y = std::max(max_y, y);
+    }
+    if(!(max_x - min_x < 65536.0f && max_y - min_y < 65536.0f)) return;
+
+    Rect box(floorf(min_x), floorf(min_y), 0, 0);
+    box.w = int32_t(ceilf(max_x)) - box.x;
+    box.h = int32_t(ceilf(max_y)) - box.y;
+    box = box.intersection(clip);
+    if(box.empty()) return;
+
+    // source position of each pixel centre, as 16.16 fixed point
+    Affine inverse = transform.inverse();
+    auto fixed = [](float f) {return int64_t(llroundf(f * 65536.0f));};
+    int64_t du_dx = fixed(inverse.a), du_dy = fixed(inverse.b);
+    int64_t dv_dx = fixed(inverse.c), dv_dy = fixed(inverse.d);
+    int64_t u0 = fixed(inverse.a * 0.5f + inverse.b * 0.5f + inverse.tx);
+    int64_t v0 = fixed(inverse.c * 0.5f + inverse.d * 0.5f + inverse.ty);
+
+    int64_t u_lo = int64_t(s.x) << 16, u_hi = (int64_t(s.x + s.w) << 16) - 1;
+    int64_t v_lo = int64_t(s.y) << 16, v_hi = (int64_t(s.y + s.h) << 16) - 1;
+
+    bool blend = supports_alpha_blend();
+    bool direct = !bilinear && alpha == 255;
+    if(!blend && alpha < 128) return;
+
+    const uint CHUNK = 32;
+    uint32_t pens[4][CHUNK];
+    BlitPenMap map(src, this);
+    uint pen = get_pen();
+    bool damaged = false;
+
+    for(auto y = box.y; y < box.y + box.h; y++) {
+      int64_t u_row = u0 + y * du_dy;
+      int64_t v_row = v0 + y * dv_dy;
+
+      int32_t x1 = box.x, x2 = box.x + box.w - 1;
+      constrain_span(u_row, du_dx, u_lo, u_hi, x1, x2);
+      constrain_span(v_row, dv_dx, v_lo, v_hi, x1, x2);
+      if(x1 > x2) continue;
+
+      if(!damaged) {
+        add_damage(box);
+        damaged = true;
+      }
+
+      for(auto x = x1; x <= x2; x += CHUNK) {
+        uint n = std::min(int32_t(CHUNK), x2 - x + 1);
+        int32_t u = u_row + x * du_dx, v = v_row + x * dv_dx;
+
+        if(direct) {
+          src->sample_pens(s, u, v, du_dx, dv_dx, n, pens[0]);
+
+          uint run = 0;
+          for(auto k = 0u; k < n; k++) {
+            if(int32_t(pens[0][k]) == transparent) {
+              if(run) set_pens(Point(x + k - run, y), run, pens[0] + k - run);
+              run = 0;
+            } else {
+              pens[0][k] = map.map(pens[0][k]);
+              run++;
+            }
+          }
+          if(run) set_pens(Point(x + n - run, y), run, pens[0] + n - run);
+          continue;
+        }
+
+        if(!bilinear) {
+          src->sample_pens(s, u, v, du_dx, dv_dx, n, pens[0]);
+          for(auto k = 0u; k < n; k++) {
+            if(int32_t(pens[0][k]) == transparent) continue;
+            set_pen(map.map(pens[0][k]));
+            if(blend) {
+              set_pixel_alpha(Point(x + k, y), alpha);
+            } else {
+              set_pixel(Point(x + k, y));
+            }
+          }
+          continue;
+        }
+
+        // the four pixels around each position, half a pixel back
+        u -= 0x8000;
+        v -= 0x8000;
+        src->sample_pens(s, u, v, du_dx, dv_dx, n, pens[0]);
+        src->sample_pens(s, u + 0x10000, v, du_dx, dv_dx, n, pens[1]);
+        src->sample_pens(s, u, v + 0x10000, du_dx, dv_dx, n, pens[2]);
+        src->sample_pens(s, u + 0x10000, v + 0x10000, du_dx, dv_dx, n, pens[3]);
+
+        for(auto k = 0u; k < n; k++, u += du_dx, v += dv_dx) {
+          uint32_t fx = (u >> 8) & 0xff, fy = (v >> 8) & 0xff;
+          uint32_t weights[4] = {
+            (256 - fx) * (256 - fy), fx * (256 - fy), (256 - fx) * fy, fx * fy
+          };
+
+          uint32_t total = 0, r = 0, g = 0, b = 0;
+          for(auto i = 0; i < 4; i++) {
+            if(!weights[i] || int32_t(pens[i][k]) == transparent) continue;
+            RGB c = src->pen_to_rgb(pens[i][k]);
+            r += c.r * weights[i];
+            g += c.g * weights[i];
+            b += c.b * weights[i];
+            total += weights[i];
+          }
+          if(!total) continue;
+
+          uint32_t coverage = (total * alpha) >> 16;
+          if(!blend && coverage < 128) continue;
+
+          set_pen(rgb_to_pen(RGB(r / total, g / total, b / total)));
+          if(!blend || coverage >= 255) {
+            set_pixel(Point(x + k, y));
+          } else {
+            set_pixel_alpha(Point(x + k, y), coverage);
+          }
+        }
+      }
+    }
+
+    set_pen(pen);
+  }
+
+  LayerStack::LayerStack(uint16_t width, uint16_t height, PicoGraphics *background)
+  : background(background), bounds(0, 0, width, height),
+    dirty(height, Span{0, 0}), background_dirty(height, Span{0, 0}) {
+    invalidate();
+  }
+
+  uint LayerStack::add(PicoGraphics *graphics, const Point &offset, int transparent, uint8_t alpha, bool cached) {
+    layers.push_back({graphics, offset, transparent, alpha, true, cached});
+    mark(Rect(offset.x, offset.y, graphics->bounds.w, graphics->bounds.h), cached);
+    return layers.size() - 1;
+  }
+
+  void LayerStack::move(uint layer, const Point &offset) {
+    Layer &l = layers[layer];
+    if(l.offset == offset) return;
+    mark(Rect(l.offset.x, l.offset.y, l.graphics->bounds.w, l.graphics->bounds.h), l.cached);
+    l.offset = offset;
+    mark(Rect(l.offset.x, l.offset.y, l.graphics->bounds.w, l.graphics->bounds.h), l.cached);
+  }
+
+  void LayerStack::set_visible(uint layer, bool visible) {
+    Layer &l = layers[layer];
+    if(l.visible == visible) return;
+    l.visible = visible;
+    mark(Rect(l.offset.x, l.offset.y, l.graphics->bounds.w, l.graphics->bounds.h), l.cached);
+  }
+
+  void LayerStack::set_alpha(uint layer, uint8_t alpha) {
+    Layer &l = layers[layer];
+    if(l.alpha == alpha) return;
+    l.alpha = alpha;
+    mark(Rect(l.offset.x, l.offset.y, l.graphics->bounds.w, l.graphics->bounds.h), l.cached);
+  }
+
+  void LayerStack::invalidate(const Rect &r) {
+    mark(r, true);
+  }
+
+  void LayerStack::invalidate() {
+    mark(bounds, true);
+  }
+
+  void LayerStack::mark(const Rect &r, bool cached) {
+    Rect m = r.intersection(bounds);
+    if(m.empty()) return;
+
+    for(auto y = m.y; y < m.y + m.h; y++) {
+      for(auto rows : {&dirty, &background_dirty}) {
+        Span &span = (*rows)[y];
+        if(span.x1 >= span.x2) {
+          span = {int16_t(m.x), int16_t(m.x + m.w)};
+        } else {
+          span.x1 = std::min(span.x1, int16_t(m.x));
+          span.x2 = std::max(span.x2, int16_t(m.x + m.w));
+        }
+        if(!cached) break;
+      }
+    }
+  }
+
+  size_t LayerStack::cached_count() const {
+    size_t count = 0;
+    if(background) {
+      while(count < layers.size() && layers[count].cached) count++;
+    }
+    return count;
+  }
+
+  // calls `compose(r)` for each run of rows needing the same columns, then
+  // forgets them
+  template<typename F>
+  static void take_dirty(std::vector<LayerStack::Span> &rows, F &&compose) {
+    for(int32_t y = 0; y < int32_t(rows.size());) {
+      LayerStack::Span span = rows[y];
+      if(span.x1 >= span.x2) {y++; continue;}
+
+      int32_t end = y + 1;
+      while(end < int32_t(rows.size()) && rows[end].x1 == span.x1 && rows[end].x2 == span.x2) end++;
+
+      compose(Rect(span.x1, y, span.x2 - span.x1, end - y));
+      for(; y < end; y++) rows[y] = {0, 0};
+    }
+  }
+
+  // Brings the display up to date with `stack`, composing only the rows
+  // that anything has been drawn to, moved or hidden in since last time.
+  //
+  // Layers are read back through get_pens(), so pens that can't read their
+  // frame buffer come out blank. Those with the same pen type and layout as
+  // us copy a row at a time, others convert as blit() would. Layers with
+  // alpha blend where we support it and are otherwise drawn where their
+  // alpha is at least half.
+  void PicoGraphics::compose(LayerStack &stack) {
+    // layers can't be recorded, they're only read when composed
+    if(display_list) return;
+
+    size_t cached = stack.cached_count();
+
+    for(auto i = 0u; i < stack.layers.size(); i++) {
+      LayerStack::Layer &layer = stack.layers[i];
+      PicoGraphics *g = layer.graphics;
+      if(layer.visible) {
+        for(auto d = 0u; d < g->damage_count; d++) {
+          Rect r = g->damage[d];
+          stack.mark(Rect(r.x + layer.offset.x, r.y + layer.offset.y, r.w, r.h), i < cached);
+        }
+      }
+      g->clear_damage();
+    }
+
+    if(cached) {
+      PicoGraphics *background = stack.background;
+      take_dirty(stack.background_dirty, [&stack, background, cached](const Rect &r) {
+        background->compose_layers(stack, 0, cached, r, true);
+      });
+      background->clear_damage();
+    } else {
+      std::fill(stack.background_dirty.begin(), stack.background_dirty.end(), LayerStack::Span{0, 0});
+    }
+
+    take_dirty(stack.dirty, [this, &stack, cached](const Rect &r) {
+      if(cached) blit(stack.background, r, Point(r.x, r.y));
+      compose_layers(stack, cached, stack.layers.size(), r, !cached);
+    });
+  }
+
+  void PicoGraphics::compose_layers(const LayerStack &stack, size_t first, size_t last, const Rect &r, bool opaque_first) {
+    bool blend = supports_alpha_blend();
+    bool opaque = opaque_first;
+
+    for(auto i = first; i < last; i++) {
+      const LayerStack::Layer &layer = stack.layers[i];
+      if(!layer.visible) continue;
+
+      PicoGraphics *src = layer.graphics;
+      Rect from(r.x - layer.offset.x, r.y - layer.offset.y, r.w, r.h);
+
+      if(opaque || layer.alpha == 255) {
+        blit(src, from, Point(r.x, r.y), 1, opaque ? -1 : layer.transparent);
+        opaque = false;
+        continue;
+      }
+      if(!blend && layer.alpha < 128) continue;
+
+      // pixels of the layer that land in `r` and our clip
+      Rect visible = from.intersection(src->bounds);
+      visible.x += layer.offset.x;
+      visible.y += layer.offset.y;
+      visible = visible.intersection(clip);
+      if(visible.empty()) continue;
+
+      add_damage(visible);
+
+      const uint CHUNK = 32;
+      uint32_t pens[CHUNK];
+      BlitPenMap map(src, this);
+      uint pen = get_pen();
+
+      for(auto y = visible.y; y < visible.y + visible.h; y++) {
+        for(auto x = visible.x; x < visible.x + visible.w; x += CHUNK) {
+          uint n = std::min(CHUNK, uint(visible.x + visible.w - x));
+          src->get_pens(Point(x - layer.offset.x, y - layer.offset.y), n, pens);
+          for(auto k = 0u; k < n; k++) {
+            if(int(pens[k]) == layer.transparent) continue;
+            set_pen(map.map(pens[k]));
+            if(blend) {
+              set_pixel_alpha(Point(x + k, y), layer.alpha);
+            } else {
+              set_pixel(Point(x + k, y));
+            }
+          }
+        }
+      }
+
+      set_pen(pen);
+    }
+  }
+
+  // Draws `map` with row `y` of the display at the top of our frame buffer,
+  // as sprites() does for strips, a row at a time. Each row works out its
+  // place in the map once and then copies a tile's width at a time.
+  void PicoGraphics::tilemap(const TileMap &map, int32_t y) {
+    if(display_list) return;
+
+    int32_t ts = map.tile_size;
+    int32_t across = ts ? map.tiles->bounds.w / ts : 0;
+    if(!across || !map.width || !map.height) return;
+    int32_t tile_count = across * (map.tiles->bounds.h / ts);
+    int32_t map_w = map.width * ts, map_h = map.height * ts;
+
+    Rect area = clip;
+    if(!map.repeat) area = area.intersection(Rect(-map.scroll.x, -map.scroll.y - y, map_w, map_h));
+    if(area.empty()) return;
+
+    add_damage(area);
+
+    auto wrap = [](int32_t v, int32_t size) {v %= size; return v < 0 ? v + size : v;};
+    bool direct = map.transparent < 0;
+
+    const uint CHUNK = 32;
+    uint32_t pens[CHUNK];
+    BlitPenMap pen_map(map.tiles, this);
+    uint pen = get_pen();
+
+    for(auto row = area.y; row < area.y + area.h; row++) {
+      int32_t my = wrap(row + y + map.scroll.y, map_h);
+      const uint8_t *tile_row = map.map + (my / ts) * map.width;
+      int32_t fy = my % ts;
+
+      int32_t mx = wrap(area.x + map.scroll.x, map_w);
+      for(auto x = area.x; x < area.x + area.w;) {
+        int32_t fx = mx % ts;
+        int32_t n = std::min(ts - fx, area.x + area.w - x);
+        int32_t t = tile_row[mx / ts];
+
+        if(t != map.empty && t < tile_count) {
+          Point s((t % across) * ts + fx, (t / across) * ts + fy);
+          if(!direct || !copy_pixels(map.tiles, s, Point(x, row), n)) {
+            // converting, and leaving out transparent runs, as blit() does
+            for(int32_t j = 0; j < n; j += CHUNK) {
+              int32_t l = std::min(int32_t(CHUNK), n - j);
+              map.tiles->get_pens(Point(s.x + j, s.y), l, pens);
+
+              int32_t run = 0;
+              for(int32_t k = 0; k < l; k++) {
+                if(int32_t(pens[k]) == map.transparent) {
+                  if(run) set_pens(Point(x + j + k - run, row), run, pens + k - run);
+                  run = 0;
+                } else {
+                  pens[k] = pen_map.map(pens[k]);
+                  run++;
+                }
+              }
+              if(run) set_pens(Point(x + j + l - run, row), run, pens + l - run);
+            }
+          }
+        }
+
+        x += n;
+        mx += n;
+        if(mx >= map_w) mx -= map_w;
+      }
+    }
+
+    // the default set_pens() plots with the pen
+    set_pen(pen);
+  }
+
+}
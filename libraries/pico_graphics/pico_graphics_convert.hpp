@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "pico_graphics_spans.hpp"
+
+// Run converters used by PicoGraphics::frame_convert to turn a stretch of
+// frame buffer into the pixel format a display expects.
+//
+// Each converter works on a contiguous run of the frame buffer. Palette
+// lookups use a table that the caller builds once per frame rather than once
+// per pixel. Output pixels are in frame buffer order, 16-bit output is
+// written two pixels per word (packed for a little endian target, which
+// RP2040 is) once the destination is word aligned.
+
+namespace pimoroni {
+  namespace convert {
+
+    using spans::word_t;
+
+    // build the table for p4_to_u16, every possible byte (two 4-bit pixels)
+    // maps to the pair of 16-bit values for its high and low nibble
+    static inline void build_p4_pair_lut(const uint16_t *lut16, uint32_t *pair_lut) {
+      for(auto i = 0u; i < 256; i++) {
+        pair_lut[i] = uint32_t(lut16[i >> 4]) | (uint32_t(lut16[i & 0xf]) << 16);
+      }
+    }
+
+    // `count` 4-bit pixels starting at pixel `i` of `buf`, each whole byte
+    // (two pixels) is one lookup in `pair_lut` when the destination allows
+    static inline void p4_to_u16(const uint8_t *buf, size_t i, size_t count, const uint16_t *lut, const uint32_t *pair_lut, uint16_t *dst) {
+      const uint8_t *src = buf + (i >> 1);
+
+      // odd first pixel is the low nibble
+      if(count && (i & 1)) {*dst++ = lut[*src++ & 0xf]; count--;}
+
+      size_t pairs = count >> 1;
+      if(uintptr_t(dst) & 0b10) {
+        // pairs would straddle words
+        for(auto n = pairs; n; n--) {
+          uint8_t b = *src++;
+          dst[0] = lut[b >> 4];
+          dst[1] = lut[b & 0xf];
+          dst += 2;
+        }
+      } else {
+        word_t *d = (word_t *)dst;
+        for(auto n = pairs; n; n--) *d++ = pair_lut[*src++];
+        dst += pairs * 2;
+      }
+
+      // odd last pixel is the high nibble
+      if(count & 1) *dst = lut[*src >> 4];
+    }
+
+    // `count` 4-bit pixels starting at pixel `i` of `buf`
+    static inline void p4_to_u32(const uint8_t *buf, size_t i, size_t count, const uint32_t *lut, uint32_t *dst) {
+      for(auto end = i + count; i < end; i++) {
+        *dst++ = lut[(buf[i >> 1] >> ((i & 1) ? 0 : 4)) & 0xf];
+      }
+    }
+
+    // `count` 8-bit pixels looked up in a 256 entry table (P8 or RGB332)
+    static inline void u8_to_u16(const uint8_t *src, size_t count, const uint16_t *lut, uint16_t *dst) {
+      // align to a word
+      if(count && (uintptr_t(dst) & 0b10)) {*dst++ = lut[*src++]; count--;}
+
+      word_t *d = (word_t *)dst;
+      while(count >= 2) {
+        *d++ = uint32_t(lut[src[0]]) | (uint32_t(lut[src[1]]) << 16);
+        src += 2;
+        count -= 2;
+      }
+      if(count) ((uint16_t *)d)[0] = lut[src[0]];
+    }
+
+    static inline void u8_to_u32(const uint8_t *src, size_t count, const uint32_t *lut, uint32_t *dst) {
+      while(count >= 4) {
+        dst[0] = lut[src[0]]; dst[1] = lut[src[1]];
+        dst[2] = lut[src[2]]; dst[3] = lut[src[3]];
+        dst += 4; src += 4;
+        count -= 4;
+      }
+      while(count--) *dst++ = lut[*src++];
+    }
+
+    static inline uint16_t rgb888_to_rgb565(uint32_t c) {
+      uint16_t p = ((c >> 8) & 0b1111100000000000) |
+                   ((c >> 5) & 0b0000011111100000) |
+                   ((c >> 3) & 0b0000000000011111);
+      return __builtin_bswap16(p);
+    }
+
+    static inline void rgb888_to_rgb565(const uint32_t *src, size_t count, uint16_t *dst) {
+      // align to a word
+      if(count && (uintptr_t(dst) & 0b10)) {*dst++ = rgb888_to_rgb565(*src++); count--;}
+
+      word_t *d = (word_t *)dst;
+      while(count >= 2) {
+        *d++ = uint32_t(rgb888_to_rgb565(src[0])) | (uint32_t(rgb888_to_rgb565(src[1])) << 16);
+        src += 2;
+        count -= 2;
+      }
+      if(count) ((uint16_t *)d)[0] = rgb888_to_rgb565(src[0]);
+    }
+
+    // spread the eight bits of `b` to the lowest bit of each nibble of a word
+    static inline uint32_t spread_nibbles(uint8_t b) {
+      uint32_t x = b;
+      x = (x | (x << 12)) & 0x000f000f;
+      x = (x | (x << 6))  & 0x03030303;
+      x = (x | (x << 3))  & 0x11111111;
+      return x;
+    }
+
+    // `count` bytes of each of the three bit planes (eight pixels per byte)
+    // to 4-bit pixels, four bytes of output for each byte of a plane
+    static inline void planes_to_p4(const uint8_t *a, const uint8_t *b, const uint8_t *c, size_t count, uint8_t *dst) {
+      word_t *d = (word_t *)dst;
+      while(count--) {
+        uint32_t nibbles = (spread_nibbles(*a++) << 2) | (spread_nibbles(*b++) << 1) | spread_nibbles(*c++);
+        // the first pixel is the most significant bit of the plane byte and
+        // the high nibble of the first output byte
+        *d++ = __builtin_bswap32(nibbles);
+      }
+    }
+
+  }
+}
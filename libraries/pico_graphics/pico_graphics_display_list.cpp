@@ -0,0 +1,240 @@
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  void DisplayList::clear() {
+    commands.clear();
+    points.clear();
+    texts.clear();
+    chars.clear();
+    sprites.clear();
+    blits.clear();
+  }
+
+  // Records drawing into `list` rather than the frame buffer until called
+  // again with nullptr. Some drawing can't be recorded and does nothing while
+  // recording: PicoVector shapes and text, compose(), sprites(), tilemap()
+  // and the affine blit(). Draw it from the render() callback instead, offset
+  // up by the strip's `y`, so it lands in each strip before it's sent on.
+  void PicoGraphics::record(DisplayList *list) {
+    display_list = list;
+
+    // replay starts unclipped, so note the clip in effect
+    if(display_list) record_command(DisplayList::CLIP, clip.y, clip.y, clip.x, clip.y, clip.w, clip.h);
+  }
+
+  DisplayList::Command *PicoGraphics::record_command(DisplayList::Op op, int32_t y1, int32_t y2, int32_t a, int32_t b, int32_t c, int32_t d) {
+    if(op != DisplayList::CLIP) {
+      // nothing recorded that can't be seen, which also keeps the rows in range
+      y1 = std::max(y1, clip.y);
+      y2 = std::min(y2, clip.y + clip.h - 1);
+      if(y1 > y2) return nullptr;
+    }
+
+    DisplayList::Command command;
+    command.op = op;
+    command.cap = 0;
+    command.thickness = 0;
+    command.y1 = y1;
+    command.y2 = y2;
+    command.pen = get_pen();
+    command.args[0] = a;
+    command.args[1] = b;
+    command.args[2] = c;
+    command.args[3] = d;
+    display_list->commands.push_back(command);
+    return &display_list->commands.back();
+  }
+
+  void PicoGraphics::record_points(DisplayList::Op op, const Point *points, size_t count) {
+    int32_t miny = points[0].y, maxy = points[0].y;
+    for(size_t i = 1; i < count; i++) {
+      miny = std::min(miny, points[i].y);
+      maxy = std::max(maxy, points[i].y);
+    }
+
+    if(record_command(op, miny, maxy, display_list->points.size(), count)) {
+      display_list->points.insert(display_list->points.end(), points, points + count);
+    }
+  }
+
+  void PicoGraphics::record_text(DisplayList::Op op, const std::string_view &t, const Point &p, int32_t wrap, float s, float a, uint8_t letter_spacing, bool fixed_width) {
+    // the rows text covers depend on the font, wrapping and rotation so lay
+    // it out now, only noting where it would draw
+    int32_t y1 = INT32_MAX, y2 = INT32_MIN;
+    auto rect_rows = [&y1, &y2](int32_t x, int32_t y, int32_t w, int32_t h) {
+      y1 = std::min(y1, y);
+      y2 = std::max(y2, y + h - 1);
+    };
+    int32_t ht = thickness == 1 ? 0 : thickness;
+    auto line_rows = [&y1, &y2, ht](int32_t x1, int32_t ly1, int32_t x2, int32_t ly2) {
+      y1 = std::min(y1, std::min(ly1, ly2) - ht);
+      y2 = std::max(y2, std::max(ly1, ly2) + ht);
+    };
+
+    if(bitmap_font) {
+      if(op == DisplayList::CHARACTER) {
+        bitmap::character(bitmap_font, rect_rows, t[0], p.x, p.y, std::max(1.0f, s), int32_t(a) % 360);
+      } else {
+        bitmap::text(bitmap_font, rect_rows, t, p.x, p.y, wrap, std::max(1.0f, s), letter_spacing, fixed_width, int32_t(a) % 360);
+      }
+    } else if(hershey_font) {
+      if(op == DisplayList::CHARACTER) {
+        hershey::glyph(hershey_font, line_rows, t[0], p.x, p.y, s, a, &glyph_cache);
+      } else {
+        hershey::text(hershey_font, line_rows, t, p.x, p.y, s, a, &glyph_cache);
+      }
+    }
+
+    if(y1 > y2) return;
+
+    if(auto command = record_command(op, y1, y2, p.x, p.y, display_list->texts.size())) {
+      // thick Hershey strokes are drawn with the line cap
+      command->cap = line_cap;
+
+      DisplayList::Text text;
+      text.bitmap_font = bitmap_font;
+      text.hershey_font = hershey_font;
+      text.thickness = thickness;
+      text.wrap = wrap;
+      text.s = s;
+      text.a = a;
+      text.letter_spacing = letter_spacing;
+      text.fixed_width = fixed_width;
+      text.offset = display_list->chars.size();
+      text.length = t.length();
+      display_list->texts.push_back(text);
+      display_list->chars.insert(display_list->chars.end(), t.begin(), t.end());
+    }
+  }
+
+  void PicoGraphics::record_sprite(void *data, const Point &sprite, const Point &dest, int scale, int transparent) {
+    if(record_command(DisplayList::SPRITE, dest.y, dest.y + 8 * scale - 1, dest.x, dest.y, display_list->sprites.size())) {
+      display_list->sprites.push_back({data, sprite, scale, transparent});
+    }
+  }
+
+  void PicoGraphics::record_blit(PicoGraphics *src, const Rect &src_rect, const Point &dest, int scale, int transparent) {
+    if(record_command(DisplayList::BLIT, dest.y, dest.y + src_rect.h * scale - 1, dest.x, dest.y, display_list->blits.size())) {
+      display_list->blits.push_back({src, src_rect, scale, transparent});
+    }
+  }
+
+  // Replays `list` into the frame buffer `strip_height` rows at a time,
+  // calling `callback` with the display row each strip starts at once it's
+  // drawn. The frame buffer need only be big enough for one strip, while
+  // rendering bounds are the size of the strip and the strip's drawing is
+  // shifted up to the top of it.
+  void PicoGraphics::render(const DisplayList &list, int32_t strip_height, strip_callback_func callback) {
+    Rect full_bounds = bounds;
+    Rect full_clip = clip;
+    uint full_thickness = thickness;
+    LineCap full_line_cap = line_cap;
+    const bitmap::font_t *full_bitmap_font = bitmap_font;
+    const hershey::font_t *full_hershey_font = hershey_font;
+    uint full_pen = get_pen();
+    DisplayList *recording = display_list;
+    display_list = nullptr;
+
+    std::vector<Point> points;
+
+    for(int32_t y = 0; y < full_bounds.h; y += strip_height) {
+      set_dimensions(full_bounds.w, std::min(strip_height, full_bounds.h - y));
+      int32_t last_y = y + bounds.h - 1;
+
+      bool pen_set = false;
+      uint32_t pen = 0;
+
+      for(auto &c : list.commands) {
+        if(c.op == DisplayList::CLIP) {
+          set_clip(Rect(c.args[0], c.args[1] - y, c.args[2], c.args[3]));
+          continue;
+        }
+
+        if(c.y2 < y || c.y1 > last_y) continue;
+
+        if(!pen_set || c.pen != pen) {
+          set_pen(c.pen);
+          pen = c.pen;
+          pen_set = true;
+        }
+
+        const int32_t *args = c.args;
+        switch(c.op) {
+          case DisplayList::PIXEL:
+            pixel(Point(args[0], args[1] - y));
+            break;
+          case DisplayList::PIXEL_SPAN:
+            pixel_span(Point(args[0], args[1] - y), args[2]);
+            break;
+          case DisplayList::RECTANGLE:
+            rectangle(Rect(args[0], args[1] - y, args[2], args[3]));
+            break;
+          case DisplayList::CIRCLE:
+            circle(Point(args[0], args[1] - y), args[2]);
+            break;
+          case DisplayList::TRIANGLE:
+          case DisplayList::POLYGON:
+            points.assign(list.points.begin() + args[0], list.points.begin() + args[0] + args[1]);
+            for(auto &p : points) p.y -= y;
+            if(c.op == DisplayList::TRIANGLE) {
+              triangle(points[0], points[1], points[2]);
+            } else {
+              polygon(points);
+            }
+            break;
+          case DisplayList::LINE:
+            line(Point(args[0], args[1] - y), Point(args[2], args[3] - y));
+            break;
+          case DisplayList::THICK_LINE:
+            thick_line(Point(args[0], args[1] - y), Point(args[2], args[3] - y), c.thickness, (LineCap)c.cap);
+            break;
+          case DisplayList::CHARACTER:
+          case DisplayList::TEXT: {
+            auto &t = list.texts[args[2]];
+            bitmap_font = t.bitmap_font;
+            hershey_font = t.hershey_font;
+            thickness = t.thickness;
+            line_cap = (LineCap)c.cap;
+            Point p(args[0], args[1] - y);
+            if(c.op == DisplayList::CHARACTER) {
+              character(list.chars[t.offset], p, t.s, t.a);
+            } else {
+              text(std::string_view(&list.chars[t.offset], t.length), p, t.wrap, t.s, t.a, t.letter_spacing, t.fixed_width);
+            }
+            break;
+          }
+          case DisplayList::SPRITE: {
+            auto &s = list.sprites[args[2]];
+            sprite(s.data, s.sprite, Point(args[0], args[1] - y), s.scale, s.transparent);
+            // sprites draw with the pen
+            pen_set = false;
+            break;
+          }
+          case DisplayList::BLIT: {
+            auto &b = list.blits[args[2]];
+            blit(b.src, b.src_rect, Point(args[0], args[1] - y), b.scale, b.transparent);
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      callback(y);
+    }
+
+    set_dimensions(full_bounds.w, full_bounds.h);
+    clip = full_clip;
+    thickness = full_thickness;
+    line_cap = full_line_cap;
+    bitmap_font = full_bitmap_font;
+    hershey_font = full_hershey_font;
+    set_pen(full_pen);
+    display_list = recording;
+
+    // everything recorded has been sent
+    clear_damage();
+  }
+
+}
@@ -0,0 +1,189 @@
+#include "pico_graphics.hpp"
+#include <string.h>
+
+namespace pimoroni {
+
+  // where each kernel sends the error of a pixel, as a column offset, rows
+  // below and weight in 16ths. Atkinson only passes on 3/4 of the error
+  // which keeps highlights and shadows clean.
+  struct DiffusionTap {
+    int8_t dx, dy, weight;
+  };
+
+  static const DiffusionTap floyd_steinberg_taps[] = {
+    {1, 0, 7}, {-1, 1, 3}, {0, 1, 5}, {1, 1, 1}, {0, 0, 0}
+  };
+
+  static const DiffusionTap atkinson_taps[] = {
+    {1, 0, 2}, {2, 0, 2}, {-1, 1, 2}, {0, 1, 2}, {1, 1, 2}, {0, 2, 2}, {0, 0, 0}
+  };
+
+  // moves column `x` on to row `y`, keeping any error owed to it
+  static void seek_column(ErrorDiffusion &diffusion, int32_t x, int32_t y) {
+    ErrorDiffusion::Column &column = diffusion.columns[x];
+    int32_t k = y - column.row;
+    if(k == 0) return;
+
+    if(k < 0 || k > 2) {
+      memset(column.error, 0, sizeof(column.error));
+    } else {
+      for(auto i = 0; i < 3; i++) {
+        for(auto ch = 0; ch < 3; ch++) {
+          column.error[i][ch] = i + k < 3 ? column.error[i + k][ch] : 0;
+        }
+      }
+    }
+    column.row = y;
+    if(!column.owed) return;
+
+    // take back error kept aside that's now in reach, and drop any for rows
+    // it has moved past
+    auto &owed = diffusion.owed;
+    column.owed = false;
+    for(size_t i = 0; i < owed.size();) {
+      ErrorDiffusion::Owed &o = owed[i];
+      if(o.x != x || o.y < y) {
+        i++;
+        continue;
+      }
+      if(o.y > y + 2) {
+        column.owed = true;
+        i++;
+        continue;
+      }
+      for(auto ch = 0; ch < 3; ch++) {
+        column.error[o.y - y][ch] += o.error[ch];
+      }
+      o = owed.back();
+      owed.pop_back();
+    }
+  }
+
+  // adds `error` for row `y` of column `x` to what it's kept aside
+  static void owe(ErrorDiffusion &diffusion, int32_t x, int32_t y, const int16_t *error) {
+    auto &owed = diffusion.owed;
+    diffusion.columns[x].owed = true;
+    for(auto &o : owed) {
+      if(o.x == x && o.y == y) {
+        for(auto ch = 0; ch < 3; ch++) o.error[ch] += error[ch];
+        return;
+      }
+    }
+    owed.push_back({int16_t(x), int16_t(y), {error[0], error[1], error[2]}});
+  }
+
+  void PicoGraphics::set_error_diffusion(ErrorDiffusion *diffusion) {
+    error_diffusion = diffusion;
+  }
+
+  // Shares `cache` between palette pens, pens with the same colours use the
+  // cells worked out by any of them. nullptr goes back to the pen's own.
+  void PicoGraphics::set_dither_cache(DitherCache *cache) {
+    dither_cache = cache;
+  }
+
+  // Draws `c` plus the error owed to `p` as the closest palette entry and
+  // passes the difference on to the neighbouring pixels still to be drawn,
+  // mirrored for rows drawn right to left. Pens without a palette use the
+  // closest pen they have.
+  void PicoGraphics::set_pixel_diffused(const Point &p, const RGB &c, bool reverse) {
+    if(!error_diffusion) {
+      set_pixel_dither(p, c);
+      return;
+    }
+    if(!bounds.contains(p)) return;
+
+    auto &columns = error_diffusion->columns;
+    if(columns.size() != size_t(bounds.w)) {
+      columns.assign(bounds.w, ErrorDiffusion::Column{0, false, {}});
+      error_diffusion->owed.clear();
+    }
+
+    ErrorDiffusion::Column &column = columns[p.x];
+    seek_column(*error_diffusion, p.x, p.y);
+
+    int16_t want[3] = {c.r, c.g, c.b};
+    for(auto ch = 0; ch < 3; ch++) {
+      want[ch] = std::clamp(want[ch] + ((column.error[0][ch] + 8) >> 4), 0, 255);
+    }
+    seek_column(*error_diffusion, p.x, p.y + 1);
+
+    RGB target(want[0], want[1], want[2]);
+    RGB drawn;
+    int i = closest_pen(target);
+    if(i >= 0) {
+      set_pen(i);
+      drawn = get_palette()[i];
+    } else {
+      uint pen = rgb_to_pen(target);
+      set_pen(pen);
+      drawn = pen_to_rgb(pen);
+    }
+    set_pixel(p);
+
+    int16_t error[3] = {
+      int16_t(target.r - drawn.r),
+      int16_t(target.g - drawn.g),
+      int16_t(target.b - drawn.b)
+    };
+    if(!(error[0] | error[1] | error[2])) return;
+
+    const DiffusionTap *tap = error_diffusion->kernel == ErrorDiffusion::ATKINSON ? atkinson_taps : floyd_steinberg_taps;
+    for(; tap->weight; tap++) {
+      int32_t x = p.x + (reverse ? -tap->dx : tap->dx);
+      if(x < 0 || x >= bounds.w) continue;
+
+      int16_t weighted[3] = {
+        int16_t(error[0] * tap->weight),
+        int16_t(error[1] * tap->weight),
+        int16_t(error[2] * tap->weight)
+      };
+
+      // columns already past that row miss out, those a block behind keep
+      // it aside and those further behind miss out too
+      ErrorDiffusion::Column &to = columns[x];
+      int32_t k = p.y + tap->dy - to.row;
+      if(k < 0 || k > ErrorDiffusion::MAX_OWED_ROWS) continue;
+      if(k > 2) {
+        owe(*error_diffusion, x, p.y + tap->dy, weighted);
+        continue;
+      }
+
+      for(auto ch = 0; ch < 3; ch++) {
+        to.error[k][ch] += weighted[ch];
+      }
+    }
+  }
+
+  template<typename T>
+  static void set_pixels_dither_row(PicoGraphics *graphics, const Point &p, uint l, const T *c) {
+    uint pen = graphics->get_pen();
+
+    if(graphics->error_diffusion) {
+      bool reverse = graphics->error_diffusion->serpentine && (p.y & 1);
+      for(auto i = 0u; i < l; i++) {
+        uint j = reverse ? l - 1 - i : i;
+        graphics->set_pixel_diffused(Point(p.x + j, p.y), RGB(c[j]), reverse);
+      }
+    } else {
+      for(auto i = 0u; i < l; i++) {
+        graphics->set_pixel_dither(Point(p.x + i, p.y), RGB(c[i]));
+      }
+    }
+
+    graphics->add_damage(Rect(p.x, p.y, l, 1));
+    graphics->set_pen(pen);
+  }
+
+  // Dithers a row of `l` pixels starting at `p`, diffusing error through
+  // rows drawn top to bottom if an ErrorDiffusion is set and otherwise with
+  // each pen's ordered dither.
+  void PicoGraphics::set_pixels_dither(const Point &p, uint l, const RGB *c) {
+    set_pixels_dither_row(this, p, l, c);
+  }
+
+  void PicoGraphics::set_pixels_dither(const Point &p, uint l, const RGB565 *c) {
+    set_pixels_dither_row(this, p, l, c);
+  }
+
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "pico_graphics_spans.hpp"
+
+// Pixel formats for the frame buffer backed PicoGraphics pens.
+//
+// Each format describes how a pen value is written into one frame buffer
+// layout, with no state of its own. PicoGraphicsT<Format> instantiates the
+// drawing loops against them so the compiler can inline the pixel writes
+// rather than making a virtual set_pixel() call per pixel.
+//
+// Every format provides:
+//   color_t                          the pen value type
+//   plot(buf, w, h, x, y, c)         write a single pixel
+//   span(buf, w, h, x, y, l, c)      write `l` pixels to the right of (x, y)
+//   get(buf, w, h, x, y)             read back the pen value of a pixel
+//   copy(dst, dw, dh, dx, dy, src, sw, sh, sx, sy, l)
+//                                    copy `l` pixels between buffers of the
+//                                    same format, which must not overlap
+//
+// where `w` and `h` are the dimensions of the frame buffer. Callers have
+// already clipped the coordinates.
+
+namespace pimoroni {
+
+  extern const uint8_t dither16_pattern[16];
+
+  namespace formats {
+
+    // 1-bit, rows of pixels packed eight to a byte. Pen values 1-14 are
+    // ordered dithered between off (0) and on (15).
+    struct Format1Bit {
+      typedef uint8_t color_t;
+
+      static inline bool lit(color_t c, int32_t x, int32_t y) {
+        if(c == 0) return false;
+        if(c == 15) return true;
+        return c > dither16_pattern[(x & 0b11) | ((y & 0b11) << 2)];
+      }
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        uint8_t *f = (uint8_t *)buf + (x / 8) + (y * w / 8);
+        uint32_t bo = 7 - (x & 0b111);
+        *f = (*f & ~(1U << bo)) | (lit(c, x, y) << bo);
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        if(x + (int32_t)l >= w) {
+          l = w - x;
+        }
+
+        // the dither pattern repeats every four pixels so a whole row of it
+        // fits in one byte
+        uint8_t pattern = 0;
+        for(auto i = 0; i < 8; i++) {
+          if(lit(c, i, y)) pattern |= 0b10000000 >> i;
+        }
+
+        spans::fill_bits((uint8_t *)buf + (y * w / 8), x, l, pattern);
+      }
+
+      // dithered pens read back as fully off or on
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        uint8_t f = ((const uint8_t *)buf)[(x / 8) + (y * w / 8)];
+        return (f & (0b10000000 >> (x & 0b111))) ? 15 : 0;
+      }
+
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        spans::copy_bits((uint8_t *)dst + (dy * dw / 8), dx, (const uint8_t *)src + (sy * sw / 8), sx, l);
+      }
+    };
+
+    // 1-bit, columns of pixels packed eight to a byte
+    struct Format1BitY {
+      typedef uint8_t color_t;
+
+      // one byte of a column, the top pixel in the most significant bit
+      static inline uint8_t column_pattern(color_t c, int32_t x) {
+        uint8_t pattern = 0;
+        for(auto i = 0; i < 8; i++) {
+          if(Format1Bit::lit(c, x, i)) pattern |= 0b10000000 >> i;
+        }
+        return pattern;
+      }
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        uint8_t *f = (uint8_t *)buf + (y / 8) + (x * h / 8);
+        uint32_t bo = 7 - (y & 0b111);
+        *f = (*f & ~(1U << bo)) | (Format1Bit::lit(c, x, y) << bo);
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        if(x + (int32_t)l >= w) {
+          l = w - x;
+        }
+
+        // pixels in a row are a column apart, step through them setting the
+        // same bit in each column
+        uint32_t stride = h / 8;
+        uint8_t *f = (uint8_t *)buf + (y / 8) + (x * stride);
+        uint8_t bit = 0b10000000 >> (y & 0b111);
+
+        uint8_t values[4];
+        for(auto i = 0; i < 4; i++) {
+          values[(x + i) & 0b11] = column_pattern(c, x + i) & bit;
+        }
+
+        for(; l--; x++) {
+          *f = (*f & ~bit) | values[x & 0b11];
+          f += stride;
+        }
+      }
+
+      // columns are contiguous, so a rectangle is a run of bits per column
+      static inline void rect(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, int32_t rw, int32_t rh, color_t c) {
+        uint32_t stride = h / 8;
+        for(auto cx = x; cx < x + rw; cx++) {
+          spans::fill_bits((uint8_t *)buf + cx * stride, y, rh, column_pattern(c, cx));
+        }
+      }
+
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        uint8_t f = ((const uint8_t *)buf)[(y / 8) + (x * h / 8)];
+        return (f & (0b10000000 >> (y & 0b111))) ? 15 : 0;
+      }
+
+      // pixels in a row are in different columns, so a pixel at a time
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        while(l--) {
+          plot(dst, dw, dh, dx++, dy, get(src, sw, sh, sx++, sy));
+        }
+      }
+    };
+
+    // 4-bit palette indices, two to a byte with the left pixel in the high nibble
+    struct FormatP4 {
+      typedef uint8_t color_t;
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        auto i = x + y * w;
+        uint8_t *f = (uint8_t *)buf + i / 2;
+        uint8_t o = (~i & 0b1) * 4;
+        *f = (*f & ~(0b1111 << o)) | (c << o);
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        spans::fill_nibbles((uint8_t *)buf, x + y * w, l, c);
+      }
+
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        auto i = x + y * w;
+        return (((const uint8_t *)buf)[i / 2] >> ((~i & 0b1) * 4)) & 0b1111;
+      }
+
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        spans::copy_nibbles((uint8_t *)dst, dx + dy * dw, (const uint8_t *)src, sx + sy * sw, l);
+      }
+    };
+
+    // one byte per pixel, palette indices (P8) or RGB332
+    struct Format8Bit {
+      typedef uint8_t color_t;
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        ((uint8_t *)buf)[y * w + x] = c;
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        spans::fill_u8((uint8_t *)buf + y * w + x, c, l);
+      }
+
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        return ((const uint8_t *)buf)[y * w + x];
+      }
+
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        spans::copy_u8((uint8_t *)dst + dy * dw + dx, (const uint8_t *)src + sy * sw + sx, l);
+      }
+    };
+
+    // byte swapped RGB565, ready to send to the display
+    struct FormatRGB565 {
+      typedef uint16_t color_t;
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        ((uint16_t *)buf)[y * w + x] = c;
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        spans::fill_u16((uint16_t *)buf + y * w + x, c, l);
+      }
+
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        return ((const uint16_t *)buf)[y * w + x];
+      }
+
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        spans::copy_u16((uint16_t *)dst + dy * dw + dx, (const uint16_t *)src + sy * sw + sx, l);
+      }
+    };
+
+    // RGB888 in the low three bytes of a 32-bit word
+    struct FormatRGB888 {
+      typedef uint32_t color_t;
+
+      static inline void plot(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, color_t c) {
+        ((uint32_t *)buf)[y * w + x] = c;
+      }
+
+      static inline void span(void *buf, int32_t w, int32_t h, int32_t x, int32_t y, uint32_t l, color_t c) {
+        spans::fill_u32((uint32_t *)buf + y * w + x, c, l);
+      }
+
+      static inline color_t get(const void *buf, int32_t w, int32_t h, int32_t x, int32_t y) {
+        return ((const uint32_t *)buf)[y * w + x];
+      }
+
+      static inline void copy(void *dst, int32_t dw, int32_t dh, int32_t dx, int32_t dy, const void *src, int32_t sw, int32_t sh, int32_t sx, int32_t sy, uint32_t l) {
+        spans::copy_u32((uint32_t *)dst + dy * dw + dx, (const uint32_t *)src + sy * sw + sx, l);
+      }
+    };
+
+  }
+}
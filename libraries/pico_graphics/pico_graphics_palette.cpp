@@ -0,0 +1,144 @@
+#include "pico_graphics.hpp"
+#include <string.h>
+
+namespace pimoroni {
+
+  // Bounds on RGB::distance from `e` to any colour in the box `lo` to `hi`.
+  // The red and blue weights depend on the mean of the two reds, which only
+  // varies a little across a cell, so each term takes its smallest or
+  // largest weight and its smallest or largest difference.
+
+  static int32_t nearest_distance(const RGB &e, const RGB &lo, const RGB &hi) {
+    auto d = [](int32_t v, int32_t lo, int32_t hi) {return v < lo ? lo - v : (v > hi ? v - hi : 0);};
+    int32_t r = d(e.r, lo.r, hi.r), g = d(e.g, lo.g, hi.g), b = d(e.b, lo.b, hi.b);
+    int32_t rmean_lo = (lo.r + e.r) / 2, rmean_hi = (hi.r + e.r) / 2;
+    return (((512 + rmean_lo) * r * r) >> 8) + 4 * g * g + (((767 - rmean_hi) * b * b) >> 8);
+  }
+
+  static int32_t furthest_distance(const RGB &e, const RGB &lo, const RGB &hi) {
+    auto d = [](int32_t v, int32_t lo, int32_t hi) {return std::max(v - lo, hi - v);};
+    int32_t r = d(e.r, lo.r, hi.r), g = d(e.g, lo.g, hi.g), b = d(e.b, lo.b, hi.b);
+    int32_t rmean_lo = (lo.r + e.r) / 2, rmean_hi = (hi.r + e.r) / 2;
+    return (((512 + rmean_hi) * r * r) >> 8) + 4 * g * g + (((767 - rmean_lo) * b * b) >> 8);
+  }
+
+  void PaletteIndex::invalidate() {
+    memset(built, 0, sizeof(built));
+    candidates.clear();
+  }
+
+  void PaletteIndex::build_cell(uint cell) {
+    RGB lo((cell >> 6) << 5, ((cell >> 3) & 0b111) << 5, (cell & 0b111) << 5);
+    RGB hi(lo.r + 31, lo.g + 31, lo.b + 31);
+
+    int32_t bound = INT32_MAX;
+    for(size_t i = 0; i < len; i++) {
+      bound = std::min(bound, furthest_distance(palette[i], lo, hi));
+    }
+
+    // in palette order so that ties go the same way as RGB::closest
+    size_t start = candidates.size();
+    for(size_t i = 0; i < len; i++) {
+      if(nearest_distance(palette[i], lo, hi) <= bound) candidates.push_back(i);
+    }
+
+    count[cell] = 0;
+    if(candidates.size() - start > MAX_CANDIDATES) {
+      candidates.resize(start);
+    } else {
+      offset[cell] = start;
+      count[cell] = candidates.size() - start;
+    }
+    built[cell >> 5] |= 1u << (cell & 31);
+  }
+
+  int PaletteIndex::closest(const RGB &c, const RGB *palette, size_t len) {
+    if(palette != this->palette || len != this->len) {
+      invalidate();
+      this->palette = palette;
+      this->len = len;
+    }
+
+    // colours carrying dither error can be outside the cube
+    if(len == 0 || len > 256 || ((c.r | c.g | c.b) & ~0xff)) return c.closest(palette, len);
+
+    uint cell = ((c.r >> 5) << 6) | ((c.g >> 5) << 3) | (c.b >> 5);
+    if(!(built[cell >> 5] & (1u << (cell & 31)))) build_cell(cell);
+    if(!count[cell]) return c.closest(palette, len);
+
+    const uint8_t *i = &candidates[offset[cell]];
+    int d = INT_MAX, m = -1;
+    for(auto n = count[cell]; n; n--, i++) {
+      int dc = c.distance(palette[*i]);
+      if(dc < d) {m = *i; d = dc;}
+    }
+    return m;
+  }
+
+  uint32_t DitherCache::new_version() {
+    static uint32_t last = 0;
+    return ++last;
+  }
+
+  void DitherCache::reset() {
+    memset(built, 0, sizeof(built));
+    std::vector<uint8_t>().swap(cells);
+  }
+
+  void DitherCache::adopt(const RGB *palette, size_t len, uint32_t version, bool expand, PaletteIndex *index) {
+    bool same = expand == this->expand && len == colours.size();
+    for(size_t i = 0; same && i < len; i++) {
+      same = palette[i].r == colours[i].r && palette[i].g == colours[i].g && palette[i].b == colours[i].b;
+    }
+
+    if(!same) {
+      memset(built, 0, sizeof(built));
+      colours.assign(palette, palette + len);
+      if(packed != (len <= 16)) cells.clear();
+      packed = len <= 16;
+    }
+
+    this->palette = palette;
+    this->index = index;
+    this->len = len;
+    this->version = version;
+    this->expand = expand;
+  }
+
+  void DitherCache::build(uint key) {
+    if(cells.empty()) cells.resize(CELLS * (packed ? 8 : 16));
+
+    uint r = (key & 0x1c0) >> 1;
+    uint g = (key & 0x38) << 2;
+    uint b = (key & 0x7) << 5;
+    RGB col(r, g, b);
+    if(expand) col = RGB(r | (r >> 3) | (r >> 6), g | (g >> 3) | (g >> 6), b | (b >> 3) | (b >> 6));
+
+    uint8_t candidates[16] = {0};
+    if(len) {
+      RGB error;
+      for(auto i = 0u; i < 16; i++) {
+        candidates[i] = index ? index->closest(col + error, palette, len) : (col + error).closest(palette, len);
+        error += (col - palette[candidates[i]]);
+      }
+
+      // sort by a rough approximation of luminance, this ensures that neighbouring
+      // pixels in the dither matrix are at extreme opposites of luminence
+      // giving a more balanced output
+      const RGB *palette = this->palette;
+      std::sort(candidates, candidates + 16, [palette](int a, int b) {
+        return palette[a].luminance() > palette[b].luminance();
+      });
+    }
+
+    if(packed) {
+      for(auto i = 0u; i < 8; i++) {
+        cells[key * 8 + i] = candidates[i * 2] | (candidates[i * 2 + 1] << 4);
+      }
+    } else {
+      memcpy(&cells[key * 16], candidates, 16);
+    }
+    built[key >> 5] |= 1u << (key & 31);
+  }
+
+}
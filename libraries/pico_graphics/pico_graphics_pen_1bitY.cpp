@@ -3,7 +3,7 @@
 namespace pimoroni {
 
   PicoGraphics_Pen1BitY::PicoGraphics_Pen1BitY(uint16_t width, uint16_t height, void *frame_buffer)
-    : PicoGraphics(width, height, frame_buffer) {
+    : PicoGraphicsT(width, height, frame_buffer) {
     this->pen_type = PEN_1BIT;
     if(this->frame_buffer == nullptr) {
       this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
@@ -18,39 +18,35 @@ namespace pimoroni {
     color = std::max(r, std::max(g, b));
   }
 
-  void PicoGraphics_Pen1BitY::set_pixel(const Point &p) {
-    // pointer to byte in framebuffer that contains this pixel
-    uint8_t *buf = (uint8_t *)frame_buffer;
-    uint8_t *f = &buf[(p.y / 8) + (p.x * bounds.h / 8)];
-
-    uint bo = 7 - (p.y & 0b111);
-
-    uint8_t _dc = 0;
+  RGB PicoGraphics_Pen1BitY::pen_to_rgb(uint pen) {
+    uint8_t v = (pen & 0xf) * 17;
+    return RGB(v, v, v);
+  }
 
-    if(color == 0) {
-      _dc = 0;
-    } else if (color == 15) {
-      _dc = 1;
-    } else {
-      uint8_t _dmv = dither16_pattern[(p.x & 0b11) | ((p.y & 0b11) << 2)];
-      _dc = color > _dmv ? 1 : 0;
-    }
+  uint PicoGraphics_Pen1BitY::rgb_to_pen(const RGB &c) {
+    return std::max(c.r, std::max(c.g, c.b)) >> 4;
+  }
 
-    // forceably clear the bit
-    *f &= ~(1U << bo); 
+  uint8_t PicoGraphics_Pen1BitY::column_pattern(int x) {
+    return formats::Format1BitY::column_pattern(color, x);
+  }
 
-    // set pixel
-    *f |= (_dc << bo);
+  void PicoGraphics_Pen1BitY::set_pixel_rect(const Rect &r) {
+    formats::Format1BitY::rect(frame_buffer, bounds.w, bounds.h, r.x, r.y, r.w, r.h, color);
   }
 
-  void PicoGraphics_Pen1BitY::set_pixel_span(const Point &p, uint l) {
-    Point lp = p;
-    if(p.x + (int)l >= bounds.w) {
-      l = bounds.w - p.x;
-    }
-    while(l--) {
-        set_pixel(lp);
-        lp.x++;
+  // columns are contiguous here, so glyphs are drawn a run of pixels down
+  // each column at a time rather than turned into rows
+  void PicoGraphics_Pen1BitY::set_pixel_glyph(const Point &p, const uint32_t *columns, uint width, uint scale) {
+    for(auto cx = 0u; cx < width; cx++) {
+      uint32_t data = columns[cx];
+      while(data) {
+        uint first = __builtin_ctz(data);
+        uint rest = ~(data >> first);
+        uint run = rest ? __builtin_ctz(rest) : 32 - first;
+        data = first + run < 32 ? data & (~0U << (first + run)) : 0;
+        formats::Format1BitY::rect(frame_buffer, bounds.w, bounds.h, p.x + cx * scale, p.y + first * scale, scale, run * scale, color);
+      }
     }
   }
 
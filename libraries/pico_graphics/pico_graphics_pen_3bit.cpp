@@ -1,4 +1,6 @@
 #include "pico_graphics.hpp"
+#include "pico_graphics_spans.hpp"
+#include "pico_graphics_convert.hpp"
 
 namespace pimoroni {
 
@@ -8,7 +10,7 @@ namespace pimoroni {
         if(this->frame_buffer == nullptr) {
             this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
         }
-        cache_built = false;
+        palette_version = DitherCache::new_version();
     }
     void PicoGraphics_Pen3Bit::_set_pixel(const Point &p, uint col) {
         uint offset = (bounds.w * bounds.h) / 8;
@@ -35,9 +37,28 @@ namespace pimoroni {
     void PicoGraphics_Pen3Bit::set_pen(uint c) {
         color = c;
     }
+    uint PicoGraphics_Pen3Bit::get_pen() {
+        return color;
+    }
     void PicoGraphics_Pen3Bit::set_pen(uint8_t r, uint8_t g, uint8_t b) {
         color = RGB(r, g, b).to_rgb888() | 0x7f000000;
     }
+    RGB PicoGraphics_Pen3Bit::pen_to_rgb(uint pen) {
+        if((pen & 0x7f000000) == 0x7f000000) return RGB(pen & 0xffffff);
+        return palette[pen & 0b111];
+    }
+    uint PicoGraphics_Pen3Bit::rgb_to_pen(const RGB &c) {
+        return RGB(c).to_rgb888() | 0x7f000000;
+    }
+    void PicoGraphics_Pen3Bit::get_pens(const Point &p, uint l, uint32_t *pens) {
+        uint offset = (bounds.w * bounds.h) / 8;
+        const uint8_t *row = (const uint8_t *)frame_buffer + (p.y * bounds.w / 8);
+        for(auto x = p.x; l--; x++) {
+            uint bo = 7 - (x & 0b111);
+            const uint8_t *f = row + x / 8;
+            *pens++ = (((f[0] >> bo) & 1) << 2) | (((f[offset] >> bo) & 1) << 1) | ((f[offset + offset] >> bo) & 1);
+        }
+    }
     int PicoGraphics_Pen3Bit::create_pen(uint8_t r, uint8_t g, uint8_t b) {
         return RGB(r, g, b).to_rgb888() | 0x7f000000;
     }
@@ -52,85 +73,59 @@ namespace pimoroni {
         }
     }
     void PicoGraphics_Pen3Bit::set_pixel_span(const Point &p, uint l) {
-        Point lp = p;
-        while(l--) {
-            if ((color & 0x7f000000) == 0x7f000000) {
-                set_pixel_dither(lp, RGB(color));
-            } else {
-                _set_pixel(lp, color);
+        // a solid colour is a run of set or cleared bits in each plane
+        uint8_t planes[3] = {
+            uint8_t((color & 0b100) ? 0xff : 0x00),
+            uint8_t((color & 0b010) ? 0xff : 0x00),
+            uint8_t((color & 0b001) ? 0xff : 0x00)
+        };
+
+        // a dithered one repeats every four pixels along the row, so each
+        // byte of a plane holds the same two repeats of that row's pattern
+        if ((color & 0x7f000000) == 0x7f000000) {
+            DitherCache &cache = dither_cache ? *dither_cache : candidate_cache;
+            cache.use(palette, palette_size, palette_version, true);
+
+            RGB c(color);
+            planes[0] = planes[1] = planes[2] = 0;
+            for(auto i = 0u; i < 4; i++) {
+                uint col = cache.get(c, i | ((p.y & 0b11) << 2));
+                uint8_t bits = 0x88 >> i;
+                if(col & 0b100) planes[0] |= bits;
+                if(col & 0b010) planes[1] |= bits;
+                if(col & 0b001) planes[2] |= bits;
             }
-            lp.x++;
-        }
-    }
-    void PicoGraphics_Pen3Bit::get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates) {
-        RGB error;
-        for(size_t i = 0; i < candidates.size(); i++) {
-            candidates[i] = (col + error).closest(palette, len);
-            error += (col - palette[candidates[i]]);
         }
 
-        // sort by a rough approximation of luminance, this ensures that neighbouring
-        // pixels in the dither matrix are at extreme opposites of luminence
-        // giving a more balanced output
-        std::sort(candidates.begin(), candidates.end(), [palette](int a, int b) {
-            return palette[a].luminance() > palette[b].luminance();
-        });
+        uint offset = (bounds.w * bounds.h) / 8;
+        uint8_t *row = (uint8_t *)frame_buffer + (p.y * bounds.w / 8);
+        spans::fill_bits(row, p.x, l, planes[0]);
+        spans::fill_bits(row + offset, p.x, l, planes[1]);
+        spans::fill_bits(row + offset + offset, p.x, l, planes[2]);
     }
-
     void PicoGraphics_Pen3Bit::set_pixel_dither(const Point &p, const RGB &c) {
         if(!bounds.contains(p)) return;
 
-        if(!cache_built) {
-            for(uint i = 0; i < 512; i++) {
-                uint r = (i & 0x1c0) >> 1;
-                uint g = (i & 0x38) << 2;
-                uint b = (i & 0x7) << 5;
-                RGB cache_col(
-                    r | (r >> 3) | (r >> 6),
-                    g | (g >> 3) | (g >> 6),
-                    b | (b >> 3) | (b >> 6)
-                );
-                get_dither_candidates(cache_col, palette, palette_size, candidate_cache[i]);
-            }
-            cache_built = true;
-        }
-
-        uint cache_key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
-        //get_dither_candidates(c, palette, 256, candidates);
+        DitherCache &cache = dither_cache ? *dither_cache : candidate_cache;
+        cache.use(palette, palette_size, palette_version, true);
 
         // find the pattern coordinate offset
         uint pattern_index = (p.x & 0b11) | ((p.y & 0b11) << 2);
 
         // set the pixel
-        //color = candidates[pattern[pattern_index]];
-        _set_pixel(p, candidate_cache[cache_key][dither16_pattern[pattern_index]]);
+        _set_pixel(p, cache.get(c, pattern_index));
     }
     void PicoGraphics_Pen3Bit::frame_convert(PenType type, conversion_callback_func callback) {
         if(type == PEN_P4) {
-            uint8_t row_buf[bounds.w / 2];
             uint offset = (bounds.w * bounds.h) / 8;
-            uint8_t *buf = (uint8_t *)frame_buffer;
-
-            for(auto y = 0; y < bounds.h; y++) {
-                for(auto x = 0; x < bounds.w; x++) {
-                    uint bo = 7 - (x & 0b111);
-
-                    uint8_t *bufA = &buf[(x / 8) + (y * bounds.w / 8)];
-                    uint8_t *bufB = bufA + offset;
-                    uint8_t *bufC = bufA + offset + offset;
-
-                    uint8_t nibble = (*bufA >> bo) & 1U;
-                    nibble <<= 1;
-                    nibble |= (*bufB >> bo) & 1U;
-                    nibble <<= 1;
-                    nibble |= (*bufC >> bo) & 1U;
-                    nibble <<= (x & 0b1) ? 0 : 4;
-
-                    row_buf[x / 2] &= (x & 0b1) ? 0b11110000 : 0b00001111;
-                    row_buf[x / 2] |= nibble;
-                }
-                callback(row_buf, bounds.w / 2);
-            }
+            const uint8_t *bufA = (const uint8_t *)frame_buffer;
+            const uint8_t *bufB = bufA + offset;
+            const uint8_t *bufC = bufA + offset + offset;
+
+            // each byte of a plane holds eight pixels, four bytes of output
+            frame_convert_chunks<uint8_t>(callback, bounds.w * bounds.h / 2, [&](size_t offset, size_t count, uint8_t *dst) {
+                convert::planes_to_p4(bufA + offset / 4, bufB + offset / 4, bufC + offset / 4, count / 4, dst);
+            });
         }
     }
 }
\ No newline at end of file
@@ -5,13 +5,24 @@ namespace pimoroni {
   : PicoGraphics(width, height, nullptr),
     driver(direct_display_driver) {
       this->pen_type = PEN_INKY7;
+      palette_version = DitherCache::new_version();
   }
   void PicoGraphics_PenInky7::set_pen(uint c) {
     color = c;
   }
+  uint PicoGraphics_PenInky7::get_pen() {
+    return color;
+  }
   void PicoGraphics_PenInky7::set_pen(uint8_t r, uint8_t g, uint8_t b) {
     color = RGB(r, g, b).to_rgb888() | 0x7f000000;
   }
+  RGB PicoGraphics_PenInky7::pen_to_rgb(uint pen) {
+    if((pen & 0x7f000000) == 0x7f000000) return RGB(pen & 0xffffff);
+    return palette[pen & 0b111];
+  }
+  uint PicoGraphics_PenInky7::rgb_to_pen(const RGB &c) {
+    return RGB(c).to_rgb888() | 0x7f000000;
+  }
   int PicoGraphics_PenInky7::create_pen(uint8_t r, uint8_t g, uint8_t b) {
     return RGB(r, g, b).to_rgb888() | 0x7f000000;
   }
@@ -27,54 +38,46 @@ namespace pimoroni {
   }
   void PicoGraphics_PenInky7::set_pixel_span(const Point &p, uint l) {
     if ((color & 0x7f000000) == 0x7f000000) {
-      for(auto x = 0u; x < l; x++) {
-        set_pixel_dither(p + Point(x, 0), RGB(color));
+      DitherCache &cache = dither_cache ? *dither_cache : candidate_cache;
+      cache.use(palette, palette_size, palette_version, true);
+
+      // the pattern repeats every four pixels along the row
+      RGB c(color);
+      uint8_t pattern[4];
+      for(auto i = 0u; i < 4; i++) {
+        pattern[i] = cache.get(c, i | ((p.y & 0b11) << 2)) & 0x07;
+      }
+
+      if(pattern[0] == pattern[1] && pattern[0] == pattern[2] && pattern[0] == pattern[3]) {
+        driver.write_pixel_span(p, l, pattern[0]);
+        return;
+      }
+
+      // otherwise written a chunk at a time, every chunk starts at the same
+      // point in the pattern so the buffer only needs filling once
+      const uint CHUNK = 64;
+      uint8_t buf[CHUNK];
+      for(auto i = 0u; i < CHUNK; i++) {
+        buf[i] = pattern[(p.x + i) & 0b11];
+      }
+      for(auto x = 0u; x < l; x += CHUNK) {
+        driver.write_pixels(Point(p.x + x, p.y), std::min(CHUNK, l - x), buf);
       }
       return;
     }
     driver.write_pixel_span(p, l, color);
   }
-  void PicoGraphics_PenInky7::get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates) {
-    RGB error;
-    for(size_t i = 0; i < candidates.size(); i++) {
-        candidates[i] = (col + error).closest(palette, len);
-        error += (col - palette[candidates[i]]);
-    }
-
-    // sort by a rough approximation of luminance, this ensures that neighbouring
-    // pixels in the dither matrix are at extreme opposites of luminence
-    // giving a more balanced output
-    std::sort(candidates.begin(), candidates.end(), [palette](int a, int b) {
-        return palette[a].luminance() > palette[b].luminance();
-    });
-  }
   void PicoGraphics_PenInky7::set_pixel_dither(const Point &p, const RGB &c) {
     if(!bounds.contains(p)) return;
 
-    if(!cache_built) {
-        for(uint i = 0; i < 512; i++) {
-            uint r = (i & 0x1c0) >> 1;
-            uint g = (i & 0x38) << 2;
-            uint b = (i & 0x7) << 5;
-            RGB cache_col(
-                r | (r >> 3) | (r >> 6),
-                g | (g >> 3) | (g >> 6),
-                b | (b >> 3) | (b >> 6)
-            );
-            get_dither_candidates(cache_col, palette, palette_size, candidate_cache[i]);
-        }
-        cache_built = true;
-    }
-
-    uint cache_key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
-    //get_dither_candidates(c, palette, 256, candidates);
+    DitherCache &cache = dither_cache ? *dither_cache : candidate_cache;
+    cache.use(palette, palette_size, palette_version, true);
 
     // find the pattern coordinate offset
     uint pattern_index = (p.x & 0b11) | ((p.y & 0b11) << 2);
 
     // set the pixel
-    //color = candidates[pattern[pattern_index]];
-    driver.write_pixel(p, candidate_cache[cache_key][dither16_pattern[pattern_index]] & 0x07);
+    driver.write_pixel(p, cache.get(c, pattern_index) & 0x07);
   }
   void PicoGraphics_PenInky7::frame_convert(PenType type, conversion_callback_func callback) {
     if(type == PEN_INKY7) {
@@ -1,8 +1,9 @@
 #include "pico_graphics.hpp"
+#include "pico_graphics_convert.hpp"
 
 namespace pimoroni {
     PicoGraphics_PenP8::PicoGraphics_PenP8(uint16_t width, uint16_t height, void *frame_buffer)
-    : PicoGraphics(width, height, frame_buffer) {
+    : PicoGraphicsT(width, height, frame_buffer) {
         this->pen_type = PEN_P8;
         if(this->frame_buffer == nullptr) {
             this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
@@ -11,20 +12,30 @@ namespace pimoroni {
             palette[i] = {uint8_t(i), uint8_t(i), uint8_t(i)};
             used[i] = false;
         }
-        cache_built = false;
+        palette_version = DitherCache::new_version();
     }
     void PicoGraphics_PenP8::set_pen(uint c) {
         color = c;
     }
     void PicoGraphics_PenP8::set_pen(uint8_t r, uint8_t g, uint8_t b) {
-        int pen = RGB(r, g, b).closest(palette, 16);
+        int pen = closest_pen(RGB(r, g, b));
         if(pen != -1) color = pen;
     }
+    RGB PicoGraphics_PenP8::pen_to_rgb(uint pen) {
+        return palette[pen & 0xff];
+    }
+    uint PicoGraphics_PenP8::rgb_to_pen(const RGB &c) {
+        return std::max(0, closest_pen(c));
+    }
+    int PicoGraphics_PenP8::closest_pen(const RGB &c) {
+        return palette_index.closest(c, palette, palette_size);
+    }
     int PicoGraphics_PenP8::update_pen(uint8_t i, uint8_t r, uint8_t g, uint8_t b) {
         i &= 0xff;
         used[i] = true;
         palette[i] = {r, g, b};
-        cache_built = false;
+        palette_version = DitherCache::new_version();
+        palette_index.invalidate();
         return i;
     }
     int PicoGraphics_PenP8::create_pen(uint8_t r, uint8_t g, uint8_t b) {
@@ -33,7 +44,8 @@ namespace pimoroni {
             if(!used[i]) {
                 palette[i] = {r, g, b};
                 used[i] = true;
-                cache_built = false;
+                palette_version = DitherCache::new_version();
+                palette_index.invalidate();
                 return i;
             }
         }
@@ -46,63 +58,29 @@ namespace pimoroni {
     int PicoGraphics_PenP8::reset_pen(uint8_t i) {
         palette[i] = {0, 0, 0};
         used[i] = false;
-        cache_built = false;
+        palette_version = DitherCache::new_version();
+        palette_index.invalidate();
         return i;
     }
-    void PicoGraphics_PenP8::set_pixel(const Point &p) {
-        uint8_t *buf = (uint8_t *)frame_buffer;
-        buf[p.y * bounds.w + p.x] = color;
-    }
-    
-    void PicoGraphics_PenP8::set_pixel_span(const Point &p, uint l) {
-        // pointer to byte in framebuffer that contains this pixel
-        uint8_t *buf = (uint8_t *)frame_buffer;
-        buf = &buf[p.y * bounds.w + p.x];
-
-        while(l--) {
-            *buf++ = color;
-        }
-    }
-
-    void PicoGraphics_PenP8::get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates) {
-        RGB error;
-        for(size_t i = 0; i < candidates.size(); i++) {
-            candidates[i] = (col + error).closest(palette, len);
-            error += (col - palette[candidates[i]]);
-        }
-
-        // sort by a rough approximation of luminance, this ensures that neighbouring
-        // pixels in the dither matrix are at extreme opposites of luminence
-        // giving a more balanced output
-        std::sort(candidates.begin(), candidates.end(), [palette](int a, int b) {
-            return palette[a].luminance() > palette[b].luminance();
-        });
-    }
 
     void PicoGraphics_PenP8::set_pixel_dither(const Point &p, const RGB &c) {
         if(!bounds.contains(p)) return;
 
-        if(!cache_built) {
-            for(uint i = 0; i < 512; i++) {
-                RGB cache_col((i & 0x1C0) >> 1, (i & 0x38) << 2, (i & 0x7) << 5);
-                get_dither_candidates(cache_col, palette, palette_size, candidate_cache[i]);
-            }
-            cache_built = true;
-        }
-
-        uint cache_key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
-        //get_dither_candidates(c, palette, 256, candidates);
+        DitherCache &cache = dither_cache ? *dither_cache : candidate_cache;
+        cache.use(palette, palette_size, palette_version, false, &palette_index);
 
         // find the pattern coordinate offset
         uint pattern_index = (p.x & 0b11) | ((p.y & 0b11) << 2);
 
         // set the pixel
-        //color = candidates[pattern[pattern_index]];
-        color = candidate_cache[cache_key][dither16_pattern[pattern_index]];
+        color = cache.get(c, pattern_index);
         set_pixel(p);
     }
 
-    void PicoGraphics_PenP8::frame_convert(PenType type, conversion_callback_func callback) {
+    void PicoGraphics_PenP8::frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) {
+        // Treat our void* frame_buffer as uint8_t
+        const uint8_t *src = (const uint8_t *)frame_buffer;
+
         if(type == PEN_RGB565) {
             // Cache the RGB888 palette as RGB565
             RGB565 cache[palette_size];
@@ -110,18 +88,17 @@ namespace pimoroni {
                 cache[i] = palette[i].to_rgb565();
             }
 
-            // Treat our void* frame_buffer as uint8_t
-            uint8_t *src = (uint8_t *)frame_buffer;
-
-            frame_convert_rgb565(callback, [&]() {
-                return cache[*src++];
+            frame_convert_chunks<RGB565>(callback, region, bounds.w, [&](size_t offset, size_t count, RGB565 *dst) {
+                convert::u8_to_u16(src + offset, count, cache, dst);
             });
         } else if (type == PEN_RGB888) {
-            // Treat our void* frame_buffer as uint8_t
-            uint8_t *src = (uint8_t *)frame_buffer;
+            RGB888 cache[palette_size];
+            for(auto i = 0u; i < palette_size; i++) {
+                cache[i] = palette[i].to_rgb888();
+            }
 
-            frame_convert_rgb888(callback, [&]() {
-                return palette[*src++].to_rgb888();
+            frame_convert_chunks<RGB888>(callback, region, bounds.w, [&](size_t offset, size_t count, RGB888 *dst) {
+                convert::u8_to_u32(src + offset, count, cache, dst);
             });
         }
     }
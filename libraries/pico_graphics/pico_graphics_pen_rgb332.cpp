@@ -1,9 +1,10 @@
 #include "pico_graphics.hpp"
+#include "pico_graphics_convert.hpp"
 #include <string.h>
 
 namespace pimoroni {
     PicoGraphics_PenRGB332::PicoGraphics_PenRGB332(uint16_t width, uint16_t height, void *frame_buffer)
-    : PicoGraphics(width, height, frame_buffer) {
+    : PicoGraphicsT(width, height, frame_buffer) {
         this->pen_type = PEN_RGB332;
         if(this->frame_buffer == nullptr) {
             this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
@@ -15,25 +16,18 @@ namespace pimoroni {
     void PicoGraphics_PenRGB332::set_pen(uint8_t r, uint8_t g, uint8_t b) {
         color = rgb_to_rgb332(r, g, b);
     }
+    RGB PicoGraphics_PenRGB332::pen_to_rgb(uint pen) {
+        return RGB((RGB332)pen);
+    }
+    uint PicoGraphics_PenRGB332::rgb_to_pen(const RGB &c) {
+        return RGB(c).to_rgb332();
+    }
     int PicoGraphics_PenRGB332::create_pen(uint8_t r, uint8_t g, uint8_t b) {
         return rgb_to_rgb332(r, g, b);
     }
     int PicoGraphics_PenRGB332::create_pen_hsv(float h, float s, float v) {
         return RGB::from_hsv(h, s, v).to_rgb332();
     }
-    void PicoGraphics_PenRGB332::set_pixel(const Point &p) {
-        uint8_t *buf = (uint8_t *)frame_buffer;
-        buf[p.y * bounds.w + p.x] = color;
-    }
-    void PicoGraphics_PenRGB332::set_pixel_span(const Point &p, uint l) {
-        // pointer to byte in framebuffer that contains this pixel
-        uint8_t *buf = (uint8_t *)frame_buffer;
-        buf = &buf[p.y * bounds.w + p.x];
-
-        while(l--) {
-            *buf++ = color;
-        }
-    }
     void PicoGraphics_PenRGB332::set_pixel_alpha(const Point &p, const uint8_t a) {
         if(!bounds.contains(p)) return;
 
@@ -90,18 +84,22 @@ namespace pimoroni {
 
         set_pixel(p);
     }
-    void PicoGraphics_PenRGB332::frame_convert(PenType type, conversion_callback_func callback) {
+    void PicoGraphics_PenRGB332::frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) {
         if(type == PEN_RGB565) {
-
             // Treat our void* frame_buffer as uint8_t
-            uint8_t *src = (uint8_t *)frame_buffer;
+            const uint8_t *src = (const uint8_t *)frame_buffer;
 
-            frame_convert_rgb565(callback, [&]() {
-                return rgb332_to_rgb565_lut[*src++];
+            frame_convert_chunks<RGB565>(callback, region, bounds.w, [&](size_t offset, size_t count, RGB565 *dst) {
+                convert::u8_to_u16(src + offset, count, rgb332_to_rgb565_lut, dst);
             });
         }
     }
     void PicoGraphics_PenRGB332::sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent) {
+        if(display_list) {
+            record_sprite(data, sprite, dest, scale, transparent);
+            return;
+        }
+
         //int sprite_x = (sprite & 0x0f) << 3;
         //int sprite_y = (sprite & 0xf0) >> 1;
         Point s {
@@ -1,8 +1,9 @@
 #include "pico_graphics.hpp"
+#include "pico_graphics_blend.hpp"
 
 namespace pimoroni {
     PicoGraphics_PenRGB565::PicoGraphics_PenRGB565(uint16_t width, uint16_t height, void *frame_buffer)
-    : PicoGraphics(width, height, frame_buffer) {
+    : PicoGraphicsT(width, height, frame_buffer) {
         this->pen_type = PEN_RGB565;
         if(this->frame_buffer == nullptr) {
             this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
@@ -15,23 +16,40 @@ namespace pimoroni {
         src_color = {r, g, b};
         color = src_color.to_rgb565(); 
     }
+    RGB PicoGraphics_PenRGB565::pen_to_rgb(uint pen) {
+        return RGB((RGB565)pen);
+    }
+    uint PicoGraphics_PenRGB565::rgb_to_pen(const RGB &c) {
+        return RGB(c).to_rgb565();
+    }
     int PicoGraphics_PenRGB565::create_pen(uint8_t r, uint8_t g, uint8_t b) {
         return RGB(r, g, b).to_rgb565();
     }
     int PicoGraphics_PenRGB565::create_pen_hsv(float h, float s, float v) {
         return RGB::from_hsv(h, s, v).to_rgb565();
     }
-    void PicoGraphics_PenRGB565::set_pixel(const Point &p) {
+    void PicoGraphics_PenRGB565::set_pixel_alpha(const Point &p, const uint8_t a) {
+        if(!bounds.contains(p)) return;
+
         uint16_t *buf = (uint16_t *)frame_buffer;
-        buf[p.y * bounds.w + p.x] = color;
+        uint16_t &dst = buf[p.y * bounds.w + p.x];
+        dst = blend::rgb565(dst, blend::spread_rgb565(color), (a + 4) >> 3);
     }
-    void PicoGraphics_PenRGB565::set_pixel_span(const Point &p, uint l) {
-        // pointer to byte in framebuffer that contains this pixel
-        uint16_t *buf = (uint16_t *)frame_buffer;
-        buf = &buf[p.y * bounds.w + p.x];
+    bool PicoGraphics_PenRGB565::render_pico_vector_tile(const Rect &tile, uint8_t* alpha_data, uint32_t stride, uint8_t alpha_type) {
+        Rect r = tile.intersection(clip);
+        if(r.empty()) return true;
+
+        // each pixel of the tile counts 2^alpha_type x 2^alpha_type samples
+        const uint32_t shift = alpha_type * 2;
+        const uint8_t *coverage = alpha_data + (r.y - tile.y) * stride + (r.x - tile.x);
+        uint16_t *row = (uint16_t *)frame_buffer + r.y * bounds.w + r.x;
 
-        while(l--) {
-            *buf++ = color;
+        for(auto y = 0; y < r.h; y++) {
+            blend::coverage_rgb565(row, coverage, r.w, color, shift);
+            coverage += stride;
+            row += bounds.w;
         }
+
+        return true;
     }
 }
\ No newline at end of file
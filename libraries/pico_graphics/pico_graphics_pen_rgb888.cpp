@@ -1,8 +1,10 @@
 #include "pico_graphics.hpp"
+#include "pico_graphics_blend.hpp"
+#include "pico_graphics_convert.hpp"
 
 namespace pimoroni {
     PicoGraphics_PenRGB888::PicoGraphics_PenRGB888(uint16_t width, uint16_t height, void *frame_buffer)
-    : PicoGraphics(width, height, frame_buffer) {
+    : PicoGraphicsT(width, height, frame_buffer) {
         this->pen_type = PEN_RGB888;
         if(this->frame_buffer == nullptr) {
             this->frame_buffer = (void *)(new uint8_t[buffer_size(width, height)]);
@@ -15,23 +17,54 @@ namespace pimoroni {
         src_color = {r, g, b};
         color = src_color.to_rgb888();
     }
+    RGB PicoGraphics_PenRGB888::pen_to_rgb(uint pen) {
+        return RGB((uint)pen);
+    }
+    uint PicoGraphics_PenRGB888::rgb_to_pen(const RGB &c) {
+        return RGB(c).to_rgb888();
+    }
     int PicoGraphics_PenRGB888::create_pen(uint8_t r, uint8_t g, uint8_t b) {
         return RGB(r, g, b).to_rgb888();
     }
     int PicoGraphics_PenRGB888::create_pen_hsv(float h, float s, float v) {
         return RGB::from_hsv(h, s, v).to_rgb888();
     }
-    void PicoGraphics_PenRGB888::set_pixel(const Point &p) {
+    void PicoGraphics_PenRGB888::set_pixel_alpha(const Point &p, const uint8_t a) {
+        if(!bounds.contains(p)) return;
+
         uint32_t *buf = (uint32_t *)frame_buffer;
-        buf[p.y * bounds.w + p.x] = color;
+        uint32_t &dst = buf[p.y * bounds.w + p.x];
+        dst = blend::rgb888(dst, color, a + (a >> 7));
     }
-    void PicoGraphics_PenRGB888::set_pixel_span(const Point &p, uint l) {
-        // pointer to byte in framebuffer that contains this pixel
-        uint32_t *buf = (uint32_t *)frame_buffer;
-        buf = &buf[p.y * bounds.w + p.x];
+    bool PicoGraphics_PenRGB888::render_pico_vector_tile(const Rect &tile, uint8_t* alpha_data, uint32_t stride, uint8_t alpha_type) {
+        Rect r = tile.intersection(clip);
+        if(r.empty()) return true;
+
+        // each pixel of the tile counts 2^alpha_type x 2^alpha_type samples
+        const uint32_t shift = alpha_type * 2;
+        const uint8_t *coverage = alpha_data + (r.y - tile.y) * stride + (r.x - tile.x);
+        uint32_t *row = (uint32_t *)frame_buffer + r.y * bounds.w + r.x;
+
+        for(auto y = 0; y < r.h; y++) {
+            blend::coverage_rgb888(row, coverage, r.w, color, shift);
+            coverage += stride;
+            row += bounds.w;
+        }
+
+        return true;
+    }
+    void PicoGraphics_PenRGB888::frame_convert_rect(PenType type, const Rect &region, conversion_callback_func callback) {
+        // Treat our void* frame_buffer as uint32_t
+        const RGB888 *src = (const RGB888 *)frame_buffer;
 
-        while(l--) {
-            *buf++ = color;
+        if(type == PEN_RGB565) {
+            frame_convert_chunks<RGB565>(callback, region, bounds.w, [&](size_t offset, size_t count, RGB565 *dst) {
+                convert::rgb888_to_rgb565(src + offset, count, dst);
+            });
+        } else if(type == PEN_RGB888) {
+            frame_convert_chunks<RGB888>(callback, region, bounds.w, [&](size_t offset, size_t count, RGB888 *dst) {
+                spans::copy_u32(dst, src + offset, count);
+            });
         }
     }
 }
\ No newline at end of file
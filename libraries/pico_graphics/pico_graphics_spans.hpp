@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string.h>
+
+// Word-wide fill and copy kernels for the frame buffer layouts used by the
+// PicoGraphics pens.
+//
+// Wide fills build a 32-bit word holding the repeated pixel value, write any
+// partial word at the start one pixel at a time until the destination is
+// word aligned, then store whole words (four per loop iteration) before
+// finishing off the tail. Byte sized layouts go straight to memset/memcpy,
+// which are already word-wide (and in ROM on RP2040).
+//
+// Packed layouts (1-bit and 4-bit) address pixels by bit or nibble index from
+// the start of a row or buffer, the most significant bit/nibble of each byte
+// is the left-most pixel.
+
+namespace pimoroni {
+  namespace spans {
+
+    // frame buffers are written as words regardless of their pixel type
+    typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+    // store `count` words of `v`, `dst` must be word aligned
+    static inline void fill_words(word_t *dst, uint32_t v, size_t count) {
+      while(count >= 4) {
+        dst[0] = v; dst[1] = v; dst[2] = v; dst[3] = v;
+        dst += 4;
+        count -= 4;
+      }
+      while(count--) *dst++ = v;
+    }
+
+    static inline void fill_u8(uint8_t *dst, uint8_t v, size_t count) {
+      memset(dst, v, count);
+    }
+
+    static inline void fill_u16(uint16_t *dst, uint16_t v, size_t count) {
+      // align to a word
+      if(count && (uintptr_t(dst) & 0b10)) {*dst++ = v; count--;}
+
+      fill_words((word_t *)dst, uint32_t(v) | (uint32_t(v) << 16), count / 2);
+
+      if(count & 1) dst[count - 1] = v;
+    }
+
+    static inline void fill_u32(uint32_t *dst, uint32_t v, size_t count) {
+      fill_words((word_t *)dst, v, count);
+    }
+
+    // fill `count` bits starting at bit `x` of `row` from the repeating byte
+    // `pattern` (0x00 or 0xff for a solid colour)
+    static inline void fill_bits(uint8_t *row, uint32_t x, size_t count, uint8_t pattern) {
+      if(!count) return;
+      uint8_t *dst = row + (x >> 3);
+      uint32_t head = x & 0b111;
+
+      // partial first byte
+      if(head) {
+        uint8_t mask = 0xff >> head;
+        if(head + count < 8) mask &= ~(0xff >> (head + count));
+        *dst = (*dst & ~mask) | (pattern & mask);
+        dst++;
+        uint32_t done = 8 - head;
+        if(count <= done) return;
+        count -= done;
+      }
+
+      // whole bytes
+      fill_u8(dst, pattern, count >> 3);
+      dst += count >> 3;
+
+      // partial last byte
+      if(count & 0b111) {
+        uint8_t mask = ~(0xff >> (count & 0b111));
+        *dst = (*dst & ~mask) | (pattern & mask);
+      }
+    }
+
+    // fill `count` nibbles starting at nibble `i` of `buf` with `nibble`
+    static inline void fill_nibbles(uint8_t *buf, uint32_t i, size_t count, uint8_t nibble) {
+      if(!count) return;
+      uint8_t *dst = buf + (i >> 1);
+      uint8_t cc = (nibble & 0xf) | (nibble << 4);
+
+      // odd first pixel is the low nibble
+      if(i & 1) {*dst = (*dst & 0xf0) | (cc & 0x0f); dst++; count--;}
+
+      fill_u8(dst, cc, count >> 1);
+      dst += count >> 1;
+
+      // odd last pixel is the high nibble
+      if(count & 1) {*dst = (*dst & 0x0f) | (cc & 0xf0);}
+    }
+
+    static inline void copy_u8(uint8_t *dst, const uint8_t *src, size_t count) {
+      memcpy(dst, src, count);
+    }
+
+    static inline void copy_u16(uint16_t *dst, const uint16_t *src, size_t count) {
+      memcpy(dst, src, count * sizeof(uint16_t));
+    }
+
+    static inline void copy_u32(uint32_t *dst, const uint32_t *src, size_t count) {
+      memcpy(dst, src, count * sizeof(uint32_t));
+    }
+
+    // copy `count` bits from bit `sx` of `src` to bit `dx` of `dst`
+    static inline void copy_bits(uint8_t *dst, uint32_t dx, const uint8_t *src, uint32_t sx, size_t count) {
+      if(!count) return;
+
+      // same alignment, everything between the partial ends is whole bytes
+      if((dx & 0b111) == (sx & 0b111)) {
+        uint8_t *d = dst + (dx >> 3);
+        const uint8_t *s = src + (sx >> 3);
+        uint32_t head = dx & 0b111;
+        if(head) {
+          uint8_t mask = 0xff >> head;
+          if(head + count < 8) mask &= ~(0xff >> (head + count));
+          *d = (*d & ~mask) | (*s & mask);
+          d++; s++;
+          uint32_t done = 8 - head;
+          if(count <= done) return;
+          count -= done;
+        }
+        copy_u8(d, s, count >> 3);
+        d += count >> 3; s += count >> 3;
+        if(count & 0b111) {
+          uint8_t mask = ~(0xff >> (count & 0b111));
+          *d = (*d & ~mask) | (*s & mask);
+        }
+        return;
+      }
+
+      // otherwise assemble each destination byte from a 16-bit window of the
+      // source, shifted into place
+      while(count) {
+        uint32_t db = dx & 0b111;
+        uint32_t n = 8 - db;
+        if(n > count) n = count;
+
+        const uint8_t *s = src + (sx >> 3);
+        uint32_t window = (uint32_t(s[0]) << 8) | ((sx & 0b111) + n > 8 ? s[1] : 0);
+        uint8_t bits = uint8_t((window << (sx & 0b111)) >> 8) >> db;
+
+        uint8_t mask = (0xff >> db) & ~(0xff >> (db + n));
+        uint8_t *d = dst + (dx >> 3);
+        *d = (*d & ~mask) | (bits & mask);
+
+        dx += n; sx += n; count -= n;
+      }
+    }
+
+    // copy `count` nibbles from nibble `si` of `src` to nibble `di` of `dst`
+    static inline void copy_nibbles(uint8_t *dst, uint32_t di, const uint8_t *src, uint32_t si, size_t count) {
+      if(!count) return;
+
+      // same alignment, copy the odd ends by hand and the rest as bytes
+      if((di & 1) == (si & 1)) {
+        uint8_t *d = dst + (di >> 1);
+        const uint8_t *s = src + (si >> 1);
+        if(di & 1) {*d = (*d & 0xf0) | (*s & 0x0f); d++; s++; count--;}
+        copy_u8(d, s, count >> 1);
+        d += count >> 1; s += count >> 1;
+        if(count & 1) {*d = (*d & 0x0f) | (*s & 0xf0);}
+        return;
+      }
+
+      // otherwise every nibble moves between the high and low halves
+      while(count--) {
+        uint8_t v = (src[si >> 1] >> ((si & 1) ? 0 : 4)) & 0xf;
+        uint8_t *d = &dst[di >> 1];
+        *d = (di & 1) ? ((*d & 0xf0) | v) : ((*d & 0x0f) | (v << 4));
+        di++; si++;
+      }
+    }
+
+  }
+}
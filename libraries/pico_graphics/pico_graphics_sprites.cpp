@@ -0,0 +1,164 @@
+#include "pico_graphics.hpp"
+#include <string.h>
+
+namespace pimoroni {
+
+  SpriteEngine::SpriteEngine(const uint8_t *sheet, uint16_t max_sprites, uint16_t height)
+  : sheet(sheet), max_sprites(max_sprites), row_start(height + 1, 0) {
+    sprite_list.reserve(max_sprites);
+  }
+
+  int SpriteEngine::add(const Sprite &sprite) {
+    if(sprite_list.size() >= max_sprites) return -1;
+    sprite_list.push_back(sprite);
+    changed = true;
+    return sprite_list.size() - 1;
+  }
+
+  void SpriteEngine::set(uint i, const Sprite &sprite) {
+    sprite_list[i] = sprite;
+    changed = true;
+  }
+
+  void SpriteEngine::move(uint i, const Point &position) {
+    if(sprite_list[i].position == position) return;
+    sprite_list[i].position = position;
+    changed = true;
+  }
+
+  void SpriteEngine::set_visible(uint i, bool visible) {
+    if(sprite_list[i].visible == visible) return;
+    sprite_list[i].visible = visible;
+    changed = true;
+  }
+
+  void SpriteEngine::clear() {
+    sprite_list.clear();
+    changed = true;
+  }
+
+  // A counting sort of the sprites into rows: each row's count goes in the
+  // slot after it, the running total makes those the start of each row,
+  // which are then used (and moved on) as each row is filled.
+  void SpriteEngine::update() {
+    if(!changed) return;
+    changed = false;
+
+    std::vector<uint16_t> order;
+    order.reserve(sprite_list.size());
+    for(auto i = 0u; i < sprite_list.size(); i++) {
+      if(sprite_list[i].visible && sprite_list[i].scale) order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) {
+      return sprite_list[a].priority < sprite_list[b].priority;
+    });
+
+    int32_t height = row_start.size() - 1;
+    auto rows = [height](const Sprite &s, int32_t &y1, int32_t &y2) {
+      y1 = std::max(s.position.y, int32_t(0));
+      y2 = std::min(s.position.y + 8 * s.scale, height);
+    };
+
+    std::fill(row_start.begin(), row_start.end(), 0);
+    for(auto i : order) {
+      int32_t y1, y2;
+      rows(sprite_list[i], y1, y2);
+      for(auto y = y1; y < y2; y++) row_start[y + 1]++;
+    }
+    for(auto y = 0; y < height; y++) row_start[y + 1] += row_start[y];
+
+    row_sprites.resize(row_start[height]);
+    for(auto i : order) {
+      int32_t y1, y2;
+      rows(sprite_list[i], y1, y2);
+      for(auto y = y1; y < y2; y++) row_sprites[row_start[y]++] = i;
+    }
+
+    // each row's start has moved on to the next's
+    for(auto y = height; y > 0; y--) row_start[y] = row_start[y - 1];
+    row_start[0] = 0;
+  }
+
+  void SpriteEngine::use_pens(PicoGraphics *graphics) {
+    if(graphics != pens_for) {
+      invalidate_pens();
+      pens_for = graphics;
+    }
+  }
+
+  void SpriteEngine::invalidate_pens() {
+    memset(pens_built, 0, sizeof(pens_built));
+  }
+
+  void SpriteEngine::build_pen(uint8_t c) {
+    pens[c] = pens_for->pen_type == PicoGraphics::PEN_RGB332 ? c : pens_for->rgb_to_pen(RGB(RGB332(c)));
+    pens_built[c >> 5] |= 1u << (c & 31);
+  }
+
+  // Draws the sprites of `engine`, a row at a time, with row `y` of the
+  // engine at the top of our frame buffer. Strips rendered from a
+  // DisplayList can have them drawn from the render() callback, passing on
+  // its `y`, as sprites aren't recorded.
+  void PicoGraphics::sprites(SpriteEngine &engine, int32_t y) {
+    if(display_list) return;
+
+    uint pen = get_pen();
+    engine.update();
+    engine.use_pens(this);
+
+    for(auto i = 0u; i < engine.count(); i++) {
+      const SpriteEngine::Sprite &s = engine.get(i);
+      if(!s.visible) continue;
+      Rect r = Rect(s.position.x, s.position.y - y, 8 * s.scale, 8 * s.scale).intersection(clip);
+      if(!r.empty()) add_damage(r);
+    }
+
+    const uint CHUNK = 64;
+    uint32_t run[CHUNK];
+
+    for(auto row = clip.y; row < clip.y + clip.h; row++) {
+      uint count;
+      const uint16_t *list = engine.row(row + y, count);
+
+      for(auto i = 0u; i < count; i++) {
+        const SpriteEngine::Sprite &s = engine.get(list[i]);
+        int32_t x1 = std::max(s.position.x, clip.x);
+        int32_t x2 = std::min(s.position.x + 8 * s.scale, clip.x + clip.w);
+        if(x1 >= x2) continue;
+
+        int32_t sy = (row + y - s.position.y) / s.scale;
+        if(s.flip & SpriteEngine::FLIP_Y) sy = 7 - sy;
+        const uint8_t *src = engine.sheet + ((s.cell.y << 3) + sy) * 128 + (s.cell.x << 3);
+
+        // step through the sheet row a pixel per `scale` written
+        int32_t step = s.flip & SpriteEngine::FLIP_X ? -1 : 1;
+        int32_t sx = (x1 - s.position.x) / s.scale;
+        int32_t fx = (x1 - s.position.x) % s.scale;
+        if(step < 0) sx = 7 - sx;
+
+        uint n = 0;
+        int32_t start = x1;
+        for(auto x = x1; x < x2; x++) {
+          uint8_t c = src[sx];
+          if(c == s.transparent) {
+            if(n) set_pens(Point(start, row), n, run);
+            n = 0;
+            start = x + 1;
+          } else {
+            run[n++] = engine.pen(c);
+            if(n == CHUNK) {
+              set_pens(Point(start, row), n, run);
+              n = 0;
+              start = x + 1;
+            }
+          }
+
+          if(++fx == s.scale) {fx = 0; sx += step;}
+        }
+        if(n) set_pens(Point(start, row), n, run);
+      }
+    }
+    set_pen(pen);
+  }
+
+}
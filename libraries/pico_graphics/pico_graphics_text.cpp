@@ -0,0 +1,202 @@
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  // Shapes `t` into `layout` in the current font, breaking lines where
+  // text() would. Returns false without touching it if it was last laid out
+  // from the same string, font and options.
+  //
+  // Justified lines gain the space they're short of the wrap width between
+  // their words, other than the last of a paragraph. Centred and right
+  // aligned lines sit within the wrap width, or within the widest line if
+  // the text doesn't wrap.
+  bool PicoGraphics::layout_text(TextLayout &layout, const std::string_view &t, int32_t wrap, float s, uint8_t letter_spacing, bool fixed_width, TextLayout::Align align) {
+    if(layout.bitmap_font == bitmap_font && layout.hershey_font == hershey_font
+    && layout.wrap == wrap && layout.s == s && layout.letter_spacing == letter_spacing
+    && layout.fixed_width == fixed_width && layout.align == align && layout.text == t) {
+      return false;
+    }
+
+    layout.text = t;
+    layout.bitmap_font = bitmap_font;
+    layout.hershey_font = hershey_font;
+    layout.wrap = wrap;
+    layout.s = s;
+    layout.letter_spacing = letter_spacing;
+    layout.fixed_width = fixed_width;
+    layout.align = align;
+    layout.glyphs.clear();
+    layout.lines.clear();
+    layout.width = 0;
+    layout.height = 0;
+
+    if(!bitmap_font && !hershey_font) return true;
+
+    // Hershey glyphs are drawn about their middle, 32 units tall, and space
+    // themselves out
+    uint8_t scale = std::max(1.0f, s);
+    int32_t spacing = bitmap_font ? letter_spacing * scale : 0;
+    int32_t pitch = bitmap_font ? (bitmap_font->height + 1) * scale : int32_t(32 * s);
+    auto advance = [this, scale, s, fixed_width](char c, unicode_sorta::codepage_t codepage) -> int32_t {
+      if(bitmap_font) return bitmap::measure_character(bitmap_font, c, scale, codepage, fixed_width);
+      return hershey::measure_glyph(hershey_font, c, s);
+    };
+    int32_t space_width = advance(' ', unicode_sorta::PAGE_195) + spacing;
+
+    auto &glyphs = layout.glyphs;
+    auto &lines = layout.lines;
+
+    int32_t x = 0, y = 0;
+    int32_t right = 0;   // right of the last glyph on the line
+    uint16_t gaps = 0;   // spaces since the line's first glyph
+    size_t first = 0;
+
+    // until its line is finished each glyph's y holds the spaces before it
+    auto finish_line = [&](bool paragraph_end) {
+      uint16_t count = glyphs.size() - first;
+      int16_t left = count ? glyphs[first].x : 0;
+
+      uint16_t total = count ? glyphs.back().y : 0;
+      int32_t extra = wrap - right;
+      bool stretch = align == TextLayout::JUSTIFY && !paragraph_end && total && extra > 0 && wrap <= INT16_MAX;
+
+      for(auto i = first; i < glyphs.size(); i++) {
+        if(stretch) glyphs[i].x += glyphs[i].y * extra / total;
+        glyphs[i].y = y;
+      }
+      if(stretch) right = wrap;
+
+      lines.push_back({uint16_t(first), count, left, int16_t(y), int16_t(count ? right - left : 0)});
+      layout.width = std::max(layout.width, right);
+
+      first = glyphs.size();
+      x = 0;
+      y += pitch;
+      right = 0;
+      gaps = 0;
+    };
+
+    unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195;
+    size_t i = 0;
+    while(i < t.length()) {
+      size_t next_space = t.find(' ', i + 1);
+      if(next_space == std::string::npos) next_space = t.length();
+
+      size_t next_linebreak = t.find('\n', i + 1);
+      if(next_linebreak == std::string::npos) next_linebreak = t.length();
+
+      size_t next_break = std::min(next_space, next_linebreak);
+
+      uint16_t word_width = 0;
+      for(size_t j = i; j < next_break; j++) {
+        if(bitmap_font && t[j] == unicode_sorta::PAGE_194_START) {
+          codepage = unicode_sorta::PAGE_194;
+          continue;
+        } else if(bitmap_font && t[j] == unicode_sorta::PAGE_195_START) {
+          continue;
+        }
+        word_width += advance(t[j], codepage) + spacing;
+        codepage = unicode_sorta::PAGE_195;
+      }
+
+      // words that would cross the wrap width start a new line
+      if(x != 0 && uint32_t(x + word_width) > (uint32_t)wrap) finish_line(false);
+
+      for(size_t j = i; j < std::min(next_break + 1, t.length()); j++) {
+        if(bitmap_font && t[j] == unicode_sorta::PAGE_194_START) {
+          codepage = unicode_sorta::PAGE_194;
+          continue;
+        } else if(bitmap_font && t[j] == unicode_sorta::PAGE_195_START) {
+          continue;
+        }
+        if(t[j] == '\n') {
+          finish_line(true);
+        } else if(t[j] == ' ') {
+          x += space_width;
+          if(glyphs.size() > first) gaps++;
+        } else {
+          int32_t w = advance(t[j], codepage);
+          glyphs.push_back({int16_t(x), int16_t(gaps), t[j], codepage});
+          right = x + w;
+          x += w + spacing;
+        }
+        codepage = unicode_sorta::PAGE_195;
+      }
+
+      i = next_break + 1;
+    }
+    finish_line(true);
+    layout.height = y;
+
+    if(align == TextLayout::CENTER || align == TextLayout::RIGHT) {
+      int32_t box = wrap > 0 && wrap <= INT16_MAX ? wrap : layout.width;
+      for(auto &line : lines) {
+        int32_t offset = box - (line.x + line.width);
+        if(align == TextLayout::CENTER) offset /= 2;
+
+        line.x += offset;
+        for(auto i = 0u; i < line.count; i++) {
+          glyphs[line.first + i].x += offset;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // Draws a layout at `p` in the font it was laid out in, turned by `a`
+  // degrees about `p` (multiples of 90 for bitmap fonts)
+  void PicoGraphics::text(const TextLayout &layout, const Point &p, float a) {
+    if(layout.glyphs.empty()) return;
+
+    const bitmap::font_t *current_bitmap_font = bitmap_font;
+    const hershey::font_t *current_hershey_font = hershey_font;
+    bitmap_font = layout.bitmap_font;
+    hershey_font = layout.hershey_font;
+
+    // where each glyph goes once turned by `a`
+    int32_t rotation = int32_t(a) % 360;
+    float as = sinf(a * float(M_PI) / 180.0f), ac = cosf(a * float(M_PI) / 180.0f);
+    auto place = [this, &p, rotation, as, ac](const TextLayout::Glyph &g) {
+      if(hershey_font) return Point(p.x + lroundf(g.x * ac - g.y * as), p.y + lroundf(g.x * as + g.y * ac));
+      switch(rotation) {
+        case 90:  return Point(p.x - g.y, p.y + g.x);
+        case 180: return Point(p.x - g.x, p.y - g.y);
+        case 270: return Point(p.x + g.y, p.y - g.x);
+        default:  return Point(p.x + g.x, p.y + g.y);
+      }
+    };
+
+    if(display_list) {
+      // recorded a glyph at a time so that each keeps its place
+      for(auto &g : layout.glyphs) {
+        char c[2] = {unicode_sorta::PAGE_194_START, g.c};
+        bool page_194 = bitmap_font && g.codepage == unicode_sorta::PAGE_194;
+        text(std::string_view(page_194 ? c : c + 1, page_194 ? 2 : 1), place(g), 0, layout.s, a, 0, false);
+      }
+    } else if(bitmap_font) {
+      uint8_t scale = std::max(1.0f, layout.s);
+      for(auto &g : layout.glyphs) {
+        bitmap_character(g.c, place(g), scale, rotation, g.codepage);
+      }
+    } else if(thickness == 1) {
+      for(auto &g : layout.glyphs) {
+        Point o = place(g);
+        hershey::glyph(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+          line(Point(x1, y1), Point(x2, y2));
+        }, g.c, o.x, o.y, layout.s, a, &glyph_cache);
+      }
+    } else {
+      for(auto &g : layout.glyphs) {
+        Point o = place(g);
+        hershey::glyph(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+          thick_line(Point(x1, y1), Point(x2, y2), thickness);
+        }, g.c, o.x, o.y, layout.s, a, &glyph_cache);
+      }
+    }
+
+    bitmap_font = current_bitmap_font;
+    hershey_font = current_hershey_font;
+  }
+
+}
@@ -15,10 +15,8 @@ namespace alright_fonts {
     utility functions
   */
   pretty_poly::rect_t measure_character(text_metrics_t &tm, uint16_t codepoint) {
-    if(tm.face.glyphs.count(codepoint) == 1) {
-      glyph_t glyph = tm.face.glyphs[codepoint];
-
-      return {0, 0, ((glyph.advance * tm.size) / 128), tm.size};
+    if(const glyph_t *glyph = tm.face.find(codepoint)) {
+      return {0, 0, ((glyph->advance * tm.size) / 128), tm.size};
     }
 
     return {0, 0, 0, 0};
@@ -29,8 +27,8 @@ namespace alright_fonts {
   */
 
   void render_character(text_metrics_t &tm, uint16_t codepoint, pretty_poly::point_t<int> origin) {
-    if(tm.face.glyphs.count(codepoint) == 1) {
-      glyph_t glyph = tm.face.glyphs[codepoint];
+    if(const glyph_t *found = tm.face.find(codepoint)) {
+      const glyph_t &glyph = *found;
 
       // scale is a fixed point 16:16 value, our font data is already scaled to
       // -128..127 so to get the pixel size we want we can just shift the
@@ -43,8 +41,8 @@ namespace alright_fonts {
 
   template<typename mat_t>
   void render_character(text_metrics_t &tm, uint16_t codepoint, pretty_poly::point_t<int> origin, mat_t transform) {
-    if(tm.face.glyphs.count(codepoint) == 1) {
-      glyph_t glyph = tm.face.glyphs[codepoint];
+    if(const glyph_t *found = tm.face.find(codepoint)) {
+      const glyph_t &glyph = *found;
 
       // scale is a fixed point 16:16 value, our font data is already scaled to
       // -128..127 so to get the pixel size we want we can just shift the
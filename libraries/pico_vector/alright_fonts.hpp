@@ -28,6 +28,12 @@ namespace alright_fonts {
 
     bool load(pretty_poly::file_io &ifs);
     bool load(std::string_view path);
+
+    // the glyph for `codepoint`, or nullptr if the font doesn't have one
+    const glyph_t *find(uint16_t codepoint) const {
+      auto glyph = glyphs.find(codepoint);
+      return glyph == glyphs.end() ? nullptr : &glyph->second;
+    }
   };
 
   enum alignment_t {
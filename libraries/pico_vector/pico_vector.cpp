@@ -81,9 +81,13 @@ namespace pimoroni {
 
       size_t next_break = std::min(next_space, next_linebreak);
 
+      // the start of the word is measured once, for wrapping and drawing
+      int16_t advances[MAX_MEASURED];
       uint16_t word_width = 0;
       for(size_t j = i; j < next_break; j++) {
-        word_width += alright_fonts::measure_character(text_metrics, text[j]).w;
+        int16_t advance = alright_fonts::measure_character(text_metrics, text[j]).w;
+        if(j - i < MAX_MEASURED) advances[j - i] = advance;
+        word_width += advance;
         word_width += text_metrics.letter_spacing;
       }
 
@@ -101,7 +105,7 @@ namespace pimoroni {
         } else {
           alright_fonts::render_character(text_metrics, text[j], caret);
         }
-        caret.x += alright_fonts::measure_character(text_metrics, text[j]).w;
+        caret.x += j < next_break && j - i < MAX_MEASURED ? advances[j - i] : alright_fonts::measure_character(text_metrics, text[j]).w;
         caret.x += text_metrics.letter_spacing;
       }
 
@@ -154,9 +158,13 @@ namespace pimoroni {
 
       size_t next_break = std::min(next_space, next_linebreak);
 
+      // the start of the word is measured once, for wrapping and drawing
+      int16_t advances[MAX_MEASURED];
       uint16_t word_width = 0;
       for(size_t j = i; j < next_break; j++) {
-        word_width += alright_fonts::measure_character(text_metrics, text[j]).w;
+        int16_t advance = alright_fonts::measure_character(text_metrics, text[j]).w;
+        if(j - i < MAX_MEASURED) advances[j - i] = advance;
+        word_width += advance;
         word_width += text_metrics.letter_spacing;
       }
 
@@ -176,7 +184,7 @@ namespace pimoroni {
           alright_fonts::render_character(text_metrics, text[j], pretty_poly::point_t<int>(origin.x + caret.x, origin.y + caret.y), transform);
         }
         pretty_poly::point_t<float> advance(
-          alright_fonts::measure_character(text_metrics, text[j]).w + text_metrics.letter_spacing,
+          (j < next_break && j - i < MAX_MEASURED ? advances[j - i] : alright_fonts::measure_character(text_metrics, text[j]).w) + text_metrics.letter_spacing,
           0
         );
         advance *= transform;
@@ -13,6 +13,9 @@ namespace pimoroni {
             alright_fonts::text_metrics_t text_metrics;
             const uint8_t alpha_map[4] {0, 128, 192, 255};
 
+            // characters of a word whose advance text() keeps from wrapping
+            static const size_t MAX_MEASURED = 32;
+
         public:
             PicoVector(PicoGraphics *graphics, void *mem = nullptr) : graphics(graphics) {
                 pretty_poly::init(mem);
@@ -20,6 +23,13 @@ namespace pimoroni {
                 set_options([this](const pretty_poly::tile_t &tile) -> void {
                     uint8_t *tile_data = tile.data;
 
+                    // tiles can't be recorded, and the frame buffer may only be a
+                    // strip, so nothing is drawn into a DisplayList (see
+                    // PicoGraphics::record())
+                    if(this->graphics->display_list) return;
+
+                    this->graphics->add_damage({tile.bounds.x, tile.bounds.y, tile.bounds.w, tile.bounds.h});
+
                     if(this->graphics->supports_alpha_blend() && pretty_poly::settings::antialias != pretty_poly::NONE) {
                         if (this->graphics->render_pico_vector_tile({tile.bounds.x, tile.bounds.y, tile.bounds.w, tile.bounds.h},
                                                                     tile.data,
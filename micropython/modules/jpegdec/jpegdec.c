@@ -48,6 +48,10 @@ STATIC const mp_map_elem_t JPEG_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_JPEG_SCALE_HALF), MP_ROM_INT(2) },
     { MP_ROM_QSTR(MP_QSTR_JPEG_SCALE_QUARTER), MP_ROM_INT(4) },
     { MP_ROM_QSTR(MP_QSTR_JPEG_SCALE_EIGHTH), MP_ROM_INT(8) },
+
+    { MP_ROM_QSTR(MP_QSTR_JPEG_DITHER_NONE), MP_ROM_INT(0) },
+    { MP_ROM_QSTR(MP_QSTR_JPEG_DITHER_ORDERED), MP_ROM_INT(1) },
+    { MP_ROM_QSTR(MP_QSTR_JPEG_DITHER_DIFFUSE), MP_ROM_INT(2) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_JPEG_globals, JPEG_globals_table);
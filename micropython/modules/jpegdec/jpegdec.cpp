@@ -23,6 +23,7 @@ typedef struct _JPEG_obj_t {
     mp_obj_base_t base;
     JPEGDEC *jpeg;
     void *dither_buffer;
+    ErrorDiffusion *diffusion;
     mp_obj_t file;
     mp_buffer_info_t buf;
     ModPicoGraphics_obj_t *graphics;
@@ -32,7 +33,14 @@ typedef struct _JPEG_obj_t {
 uint8_t current_flags = 0;
 
 enum FLAGS : uint8_t {
-    FLAG_NO_DITHER = 1u
+    FLAG_NO_DITHER = 1u,
+    FLAG_DIFFUSE = 2u
+};
+
+enum DITHER : uint8_t {
+    DITHER_NONE = 0u,
+    DITHER_ORDERED = 1u,
+    DITHER_DIFFUSE = 2u
 };
 
 
@@ -128,6 +136,11 @@ MICROPY_EVENT_POLL_HOOK
                 current_graphics->pixel({pDraw->x + x, pDraw->y + y});
             }
         }
+    } else if((current_flags & FLAG_DIFFUSE) && current_graphics->get_palette_size()) {
+        // Error diffused output to the palette, a row of the block at a time
+        for(int y = 0; y < pDraw->iHeight; y++) {
+            current_graphics->set_pixels_dither({pDraw->x, pDraw->y + y}, pDraw->iWidthUsed, &pDraw->pPixels[y * pDraw->iWidth]);
+        }
     } else {
         for(int y = 0; y < pDraw->iHeight; y++) {
             for(int x = 0; x < pDraw->iWidth; x++) {
@@ -152,7 +165,7 @@ MICROPY_EVENT_POLL_HOOK
                 || current_graphics->pen_type == PicoGraphics::PEN_3BIT
                 || current_graphics->pen_type == PicoGraphics::PEN_INKY7) {
                     if (current_flags & FLAG_NO_DITHER) {
-                        int closest = RGB((RGB565)pDraw->pPixels[i]).closest(current_graphics->get_palette(), current_graphics->get_palette_size());
+                        int closest = current_graphics->closest_pen(RGB((RGB565)pDraw->pPixels[i]));
                         if (closest == -1) {
                             closest = 0;
                         }
@@ -190,6 +203,7 @@ mp_obj_t _JPEG_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
     self->base.type = &JPEG_type;
     self->jpeg = m_new_class(JPEGDEC);
     self->graphics = (ModPicoGraphics_obj_t *)MP_OBJ_TO_PTR(args[ARG_picographics].u_obj);
+    self->diffusion = nullptr;
 
     return self;
 }
@@ -197,6 +211,10 @@ mp_obj_t _JPEG_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
 mp_obj_t _JPEG_del(mp_obj_t self_in) {
     _JPEG_obj_t *self = MP_OBJ_TO_PTR2(self_in, _JPEG_obj_t);
     self->jpeg->close();
+    // don't leave the graphics pointing at our error buffers
+    if(self->diffusion && self->graphics->graphics->error_diffusion == self->diffusion) {
+        self->graphics->graphics->set_error_diffusion(nullptr);
+    }
     return mp_const_none;
 }
 
@@ -242,7 +260,16 @@ mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
     int y = args[ARG_y].u_int;
     int f = args[ARG_scale].u_int;
 
-    current_flags = args[ARG_dither].u_obj == mp_const_false ? FLAG_NO_DITHER : 0;
+    // dither may be True/False or one of the JPEG_DITHER_ constants
+    mp_obj_t dither = args[ARG_dither].u_obj;
+    int dither_mode = mp_obj_is_int(dither) ? mp_obj_get_int(dither) : (mp_obj_is_true(dither) ? DITHER_ORDERED : DITHER_NONE);
+
+    current_flags = 0;
+    if(dither_mode == DITHER_NONE) {
+        current_flags = FLAG_NO_DITHER;
+    } else if(dither_mode == DITHER_DIFFUSE) {
+        current_flags = FLAG_DIFFUSE;
+    }
 
     // Just-in-time open of the filename/buffer we stored in self->file via open_RAM or open_file
 
@@ -269,6 +296,16 @@ mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
     
     if(result != 1) mp_raise_msg(&mp_type_RuntimeError, "JPEG: could not read file/buffer.");
 
+    // Only diffuse once the file is open, so a failed open can't leave the
+    // PicoGraphics surface pointing at our buffers
+    if(current_flags & FLAG_DIFFUSE) {
+        if(!self->diffusion) self->diffusion = m_new_class(ErrorDiffusion);
+        self->diffusion->reset();
+        // right to left rows would push error back into blocks already drawn
+        self->diffusion->serpentine = false;
+        self->graphics->graphics->set_error_diffusion(self->diffusion);
+    }
+
     // Force a specific data output type to best match our PicoGraphics buffer
     switch(self->graphics->graphics->pen_type) {
         case PicoGraphics::PEN_RGB332:
@@ -295,6 +332,9 @@ mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
 
     result = self->jpeg->decode(x, y, f);
 
+    if(current_flags & FLAG_DIFFUSE) {
+        self->graphics->graphics->set_error_diffusion(nullptr);
+    }
     current_flags = 0;
 
     // Close the file since we've opened it on-demand
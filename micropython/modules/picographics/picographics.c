@@ -38,6 +38,10 @@ MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_measure_text_obj, 1, ModPicoGraphics_
 MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_polygon_obj, 2, ModPicoGraphics_polygon);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_triangle_obj, 7, 7, ModPicoGraphics_triangle);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_line_obj, 5, 6, ModPicoGraphics_line);
+MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_points_obj, ModPicoGraphics_points);
+MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_lines_obj, ModPicoGraphics_lines);
+MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_rectangles_obj, ModPicoGraphics_rectangles);
+MP_DEFINE_CONST_FUN_OBJ_3(ModPicoGraphics_circles_obj, ModPicoGraphics_circles);
 
 // Sprites
 MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_set_spritesheet_obj, ModPicoGraphics_set_spritesheet);
@@ -74,6 +78,10 @@ STATIC const mp_rom_map_elem_t ModPicoGraphics_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_polygon), MP_ROM_PTR(&ModPicoGraphics_polygon_obj) },
     { MP_ROM_QSTR(MP_QSTR_triangle), MP_ROM_PTR(&ModPicoGraphics_triangle_obj) },
     { MP_ROM_QSTR(MP_QSTR_line), MP_ROM_PTR(&ModPicoGraphics_line_obj) },
+    { MP_ROM_QSTR(MP_QSTR_points), MP_ROM_PTR(&ModPicoGraphics_points_obj) },
+    { MP_ROM_QSTR(MP_QSTR_lines), MP_ROM_PTR(&ModPicoGraphics_lines_obj) },
+    { MP_ROM_QSTR(MP_QSTR_rectangles), MP_ROM_PTR(&ModPicoGraphics_rectangles_obj) },
+    { MP_ROM_QSTR(MP_QSTR_circles), MP_ROM_PTR(&ModPicoGraphics_circles_obj) },
 
     { MP_ROM_QSTR(MP_QSTR_set_spritesheet), MP_ROM_PTR(&ModPicoGraphics_set_spritesheet_obj) },
     { MP_ROM_QSTR(MP_QSTR_load_spritesheet), MP_ROM_PTR(&ModPicoGraphics_load_spritesheet_obj) },
@@ -1102,4 +1102,103 @@ mp_obj_t ModPicoGraphics_line(size_t n_args, const mp_obj_t *args) {
 
     return mp_const_none;
 }
+
+// Batched primitives take an array.array (or other buffer) of integers
+
+static size_t buffer_int_size(const mp_buffer_info_t &info) {
+    switch(info.typecode) {
+        case 'b': case 'B': return 1;
+        case 'h': case 'H': return 2;
+        case 'i': case 'I': case 'l': case 'L': return 4;
+    }
+    mp_raise_TypeError("expected an array of integers");
+}
+
+// reads `count` integers from `index` on
+static void buffer_get_ints(const mp_buffer_info_t &info, size_t index, size_t count, int32_t *out) {
+    for(size_t i = 0; i < count; i++, index++) {
+        switch(info.typecode) {
+            case 'b': out[i] = ((int8_t *)info.buf)[index]; break;
+            case 'B': out[i] = ((uint8_t *)info.buf)[index]; break;
+            case 'h': out[i] = ((int16_t *)info.buf)[index]; break;
+            case 'H': out[i] = ((uint16_t *)info.buf)[index]; break;
+            default: out[i] = ((int32_t *)info.buf)[index]; break;
+        }
+    }
+}
+
+typedef void (*draw_points_func)(PicoGraphics *graphics, const Point *points, size_t count, int32_t r);
+
+// draws the points of a buffer of x, y pairs a chunk at a time, each chunk
+// starting `overlap` points back from the end of the last
+static void buffer_points(PicoGraphics *graphics, mp_obj_t buffer, size_t overlap, int32_t r, draw_points_func draw) {
+    const size_t CHUNK = 64;
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buffer, &bufinfo, MP_BUFFER_READ);
+    size_t total = bufinfo.len / buffer_int_size(bufinfo) / 2;
+
+    int32_t values[CHUNK * 2];
+    Point points[CHUNK];
+    for(size_t first = 0; first < total; first += CHUNK - overlap) {
+        size_t count = std::min(CHUNK, total - first);
+        buffer_get_ints(bufinfo, first * 2, count * 2, values);
+        for(size_t i = 0; i < count; i++) {
+            points[i] = Point(values[i * 2], values[i * 2 + 1]);
+        }
+        draw(graphics, points, count, r);
+        if(first + count == total) break;
+    }
+}
+
+mp_obj_t ModPicoGraphics_points(mp_obj_t self_in, mp_obj_t points) {
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
+
+    buffer_points(self->graphics, points, 0, 0, [](PicoGraphics *graphics, const Point *p, size_t count, int32_t r) {
+        graphics->points(p, count);
+    });
+
+    return mp_const_none;
+}
+
+mp_obj_t ModPicoGraphics_lines(mp_obj_t self_in, mp_obj_t points) {
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
+
+    buffer_points(self->graphics, points, 1, 0, [](PicoGraphics *graphics, const Point *p, size_t count, int32_t r) {
+        graphics->lines(p, count);
+    });
+
+    return mp_const_none;
+}
+
+mp_obj_t ModPicoGraphics_rectangles(mp_obj_t self_in, mp_obj_t rects) {
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
+
+    const size_t CHUNK = 32;
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(rects, &bufinfo, MP_BUFFER_READ);
+    size_t total = bufinfo.len / buffer_int_size(bufinfo) / 4;
+
+    int32_t values[CHUNK * 4];
+    Rect r[CHUNK];
+    for(size_t first = 0; first < total; first += CHUNK) {
+        size_t count = std::min(CHUNK, total - first);
+        buffer_get_ints(bufinfo, first * 4, count * 4, values);
+        for(size_t i = 0; i < count; i++) {
+            r[i] = Rect(values[i * 4], values[i * 4 + 1], values[i * 4 + 2], values[i * 4 + 3]);
+        }
+        self->graphics->rectangles(r, count);
+    }
+
+    return mp_const_none;
+}
+
+mp_obj_t ModPicoGraphics_circles(mp_obj_t self_in, mp_obj_t centres, mp_obj_t r) {
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
+
+    buffer_points(self->graphics, centres, 0, mp_obj_get_int(r), [](PicoGraphics *graphics, const Point *p, size_t count, int32_t r) {
+        graphics->circles(p, count, r);
+    });
+
+    return mp_const_none;
+}
 }
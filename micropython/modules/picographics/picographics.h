@@ -95,6 +95,10 @@ extern mp_obj_t ModPicoGraphics_measure_text(size_t n_args, const mp_obj_t *pos_
 extern mp_obj_t ModPicoGraphics_polygon(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t ModPicoGraphics_triangle(size_t n_args, const mp_obj_t *args);
 extern mp_obj_t ModPicoGraphics_line(size_t n_args, const mp_obj_t *args);
+extern mp_obj_t ModPicoGraphics_points(mp_obj_t self_in, mp_obj_t points);
+extern mp_obj_t ModPicoGraphics_lines(mp_obj_t self_in, mp_obj_t points);
+extern mp_obj_t ModPicoGraphics_rectangles(mp_obj_t self_in, mp_obj_t rects);
+extern mp_obj_t ModPicoGraphics_circles(mp_obj_t self_in, mp_obj_t centres, mp_obj_t r);
 
 // Sprites
 extern mp_obj_t ModPicoGraphics_set_spritesheet(mp_obj_t self_in, mp_obj_t spritedata);
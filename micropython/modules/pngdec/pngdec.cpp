@@ -31,6 +31,7 @@ typedef struct _PNG_obj_t {
     mp_obj_base_t base;
     PNG *png;
     void *dither_buffer;
+    ErrorDiffusion *diffusion;
     mp_obj_t file;
     mp_buffer_info_t buf;
     PNG_DRAW_CALLBACK *decode_callback;
@@ -44,6 +45,7 @@ enum DECODE_MODE : uint8_t {
     MODE_POSTERIZE = 0u,
     MODE_DITHER = 1u,
     MODE_COPY = 2u,
+    MODE_DIFFUSE = 3u,
 };
 
 void *pngdec_open_callback(const char *filename, int32_t *size) {
@@ -117,6 +119,17 @@ void pngdec_open_helper(_PNG_obj_t *self) {
     if(result != 0) mp_raise_msg(&mp_type_RuntimeError, "PNG: could not read file/buffer.");
 }
 
+// Error diffused output to the palette, each pixel of a scaled up source
+// pixel is diffused on its own so the error reaches its neighbours
+static void pngdec_diffuse(PicoGraphics *graphics, const Point &p, const Point &scale, const RGB &c) {
+    for(auto py = 0; py < scale.y; py++) {
+        for(auto px = 0; px < scale.x; px++) {
+            graphics->set_pixel_diffused(p + Point{px, py}, c);
+        }
+    }
+    graphics->add_damage({p.x, p.y, scale.x, scale.y});
+}
+
 void PNGDraw(PNGDRAW *pDraw) {
 #ifdef MICROPY_EVENT_POLL_HOOK
 MICROPY_EVENT_POLL_HOOK
@@ -129,6 +142,9 @@ MICROPY_EVENT_POLL_HOOK
     int rotation = target->rotation;
     Point step = {0, 0};
 
+    // error diffusion needs each column drawn top to bottom
+    bool diffuse = current_mode == MODE_DIFFUSE && rotation == 0 && current_graphics->get_palette_size();
+
     // "pixel" is slow and clipped,
     // guaranteeing we wont draw png data out of the framebuffer..
     // Can we clip beforehand and make this faster?
@@ -166,8 +182,12 @@ MICROPY_EVENT_POLL_HOOK
             uint8_t g = *pixel++;
             uint8_t b = *pixel++;
             if(x < target->source.x || x >= target->source.x + target->source.w) continue;
-            current_graphics->set_pen(r, g, b);
-            current_graphics->rectangle({current_position.x, current_position.y, scale.x, scale.y});
+            if (diffuse) {
+                pngdec_diffuse(current_graphics, current_position, scale, {r, g, b});
+            } else {
+                current_graphics->set_pen(r, g, b);
+                current_graphics->rectangle({current_position.x, current_position.y, scale.x, scale.y});
+            }
             current_position += step;
         }
     } else if (pDraw->iPixelType == PNG_PIXEL_TRUECOLOR_ALPHA) {
@@ -177,7 +197,9 @@ MICROPY_EVENT_POLL_HOOK
             uint8_t b = *pixel++;
             uint8_t a = *pixel++;
             if(x < target->source.x || x >= target->source.x + target->source.w) continue;
-            if (a) {
+            if (a && diffuse) {
+                pngdec_diffuse(current_graphics, current_position, scale, {r, g, b});
+            } else if (a) {
                 current_graphics->set_pen(r, g, b);
                 current_graphics->rectangle({current_position.x, current_position.y, scale.x, scale.y});
             }
@@ -230,12 +252,14 @@ MICROPY_EVENT_POLL_HOOK
                             current_graphics->rectangle({current_position.x, current_position.y, scale.x, scale.y});
                         // Posterized output to the available palete
                         } else if(current_mode == MODE_POSTERIZE) {
-                            int closest = RGB(r, g, b).closest(current_graphics->get_palette(), current_graphics->get_palette_size());
+                            int closest = current_graphics->closest_pen(RGB(r, g, b));
                             if (closest == -1) {
                                 closest = 0;
                             }
                             current_graphics->set_pen(closest);
                             current_graphics->rectangle({current_position.x, current_position.y, scale.x, scale.y});
+                        } else if(diffuse) {
+                            pngdec_diffuse(current_graphics, current_position, scale, {r, g, b});
                         } else {
                             for(auto px = 0; px < scale.x; px++) {
                                 for(auto py = 0; py < scale.y; py++) {
@@ -278,6 +302,7 @@ mp_obj_t _PNG_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, co
     self->decode_target = m_new(_PNG_decode_target, 1);
     self->decode_target->target = (void *)graphics->graphics;
     self->decode_into_buffer = false;
+    self->diffusion = nullptr;
 
     return self;
 }
@@ -285,6 +310,11 @@ mp_obj_t _PNG_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, co
 mp_obj_t _PNG_del(mp_obj_t self_in) {
     _PNG_obj_t *self = MP_OBJ_TO_PTR2(self_in, _PNG_obj_t);
     self->png->close();
+    // don't leave the graphics pointing at our error buffers
+    PicoGraphics *graphics = (PicoGraphics *)self->decode_target->target;
+    if(self->diffusion && graphics->error_diffusion == self->diffusion) {
+        graphics->set_error_diffusion(nullptr);
+    }
     return mp_const_none;
 }
 
@@ -397,8 +427,21 @@ mp_obj_t _PNG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 
     pngdec_open_helper(self);
 
+    // Only diffuse once the file is open, so a failed open can't leave the
+    // PicoGraphics surface pointing at our buffers
+    PicoGraphics *graphics = (PicoGraphics *)self->decode_target->target;
+    if(self->decode_target->mode == MODE_DIFFUSE) {
+        if(!self->diffusion) self->diffusion = m_new_class(ErrorDiffusion);
+        self->diffusion->reset();
+        graphics->set_error_diffusion(self->diffusion);
+    }
+
     result = self->png->decode(self->decode_target, 0);
 
+    if(self->decode_target->mode == MODE_DIFFUSE) {
+        graphics->set_error_diffusion(nullptr);
+    }
+
     // Close the file since we've opened it on-demand
     self->png->close();
 